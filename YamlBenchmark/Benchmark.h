@@ -0,0 +1,85 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace benchmark {
+
+    inline bool jsonOutput = false; /// Set by --json. Benchmarks that support it print one JSON object per result instead of a table.
+
+    /**
+     * @brief Runs the body repeatedly and measures the average wall time per call.
+     * @param iterations How many times the body is run.
+     * @param body Callable taking no arguments.
+     * @return The average time per call in nanoseconds.
+     */
+    template<typename F>
+    double MeasureNanoseconds(size_t iterations, F&& body) {
+        auto start = std::chrono::steady_clock::now();
+
+        for (size_t i = 0; i < iterations; i++)
+            body();
+
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+    }
+
+    /**
+     * @brief Keeps a value alive so the optimizer cannot remove the work that produced it.
+     * @param value The value to keep.
+     */
+    template<typename T>
+    void DoNotOptimize(const T& value) {
+        static volatile uint64_t sink = 0;
+        sink = sink + static_cast<uint64_t>(value);
+    }
+}
+
+/**
+ * @brief Compares the hand-written scalar classifiers to the std::regex versions they replaced.
+ * @return 0 on success, 1 if the two implementations disagree on any input.
+ */
+int RunClassifierBenchmark();
+
+/**
+ * @brief Measures how fast StructuralIndex finds the characters the parser has to look at,
+ *        compared to testing every byte with std::string::find, and the parser it feeds.
+ * @return 0 on success, 1 if the two disagree or an input does not parse.
+ */
+int RunStructuralIndexBenchmark();
+
+/**
+ * @brief Compares parsing valid documents to parsing broken ones, alone and under concurrent load,
+ *        and a handler that fails with Fail to one that throws.
+ * @return 0 on success, 1 if a document does not parse or fail as expected.
+ */
+int RunErrorPathBenchmark();
+
+/**
+ * @brief Measures the time from an edit to the validation result of the edited document,
+ *        for documents of growing size, compared to parsing and validating the whole text.
+ * @return 0 on success, 1 if a result differs from what the edit should give.
+ */
+int RunIncrementalBenchmark();
+
+/**
+ * @brief Measures parse throughput, validation throughput, allocations per document and peak heap
+ *        use for documents of different shapes: wide, long, deep, block and flow style, scalar heavy
+ *        and quote heavy. Prints JSON lines with --json.
+ * @return 0 on success, 1 if a document does not parse or validate.
+ */
+int RunSuiteBenchmark();
+
+/**
+ * @brief Measures validation of large documents made by CorpusGenerator, in block and flow style,
+ *        valid and with a type mismatch or a syntax error. Prints JSON lines with --json.
+ * @return 0 on success, 1 if a document does not validate or fail as expected.
+ */
+int RunCorpusBenchmark();
+
+/**
+ * @brief Measures validation of a list of entries of several kinds, each an object alternative of an Either,
+ *        tried in turn compared to picked by a discriminator key. Prints JSON lines with --json.
+ * @return 0 on success, 1 if the document does not parse or validate.
+ */
+int RunEitherBenchmark();
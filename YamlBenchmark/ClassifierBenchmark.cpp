@@ -0,0 +1,103 @@
+#include "Benchmark.h"
+#include "YamlParser.h"
+
+#include <cstdio>
+#include <regex>
+#include <string>
+#include <vector>
+
+/*
+ * The classifiers exactly as they were implemented with std::regex,
+ * including building the regex on every call.
+ */
+namespace reference {
+
+    static bool IsNumber(const std::string& v) {
+        if (v == ".nan"  || v == ".NaN"  || v == ".NAN"
+         || v == ".inf"  || v == ".Inf"  || v == ".INF"
+         || v == "-.inf" || v == "-.Inf" || v == "-.INF") return true;
+
+        if (v[0] == '0' && v[1] == 'x' && v.size() > 2) {
+            for (size_t i = 2; i < v.size(); i++) {
+                if (!(v[i] >= '0' && v[i] <= '9') &&
+                    !(v[i] >= 'A' && v[i] <= 'F') &&
+                    !(v[i] >= 'a' && v[i] <= 'f')) return false;
+            }
+            return true;
+        }
+
+        else if (v[0] == '0' && v[1] == 'o' && v.size() > 2) {
+            for (size_t i = 2; i < v.size(); i++) {
+                if (v[i] < '0' || v[i] > '7') return false;
+            }
+            return true;
+        }
+
+        return std::regex_match(v, std::regex(R"([-+]?(\.[0-9]+|[0-9]+(\.[0-9]*)?)([eE][-+]?[0-9]+)?)"));
+    }
+
+    static bool IsTimestamp(const std::string& v) {
+        return std::regex_match(v, std::regex(R"(^([\+-]?\d{4}(?!\d{2}\b))((-?)((0[1-9]|1[0-2])(\3([12]\d|0[1-9]|3[01]))?|W([0-4]\d|5[0-2])(-?[1-7])?|(00[1-9]|0[1-9]\d|[12]\d{2}|3([0-5]\d|6[1-6])))([T\s]((([01]\d|2[0-3])((:?)[0-5]\d)?|24\:?00)([\.,]\d+(?!:))?)?(\17[0-5]\d([\.,]\d+)?)?([zZ]|([\+-])([01]\d|2[0-3]):?([0-5]\d)?)?)?)?$)"));
+    }
+}
+
+/// Unquoted scalars of the kind found in real configuration files.
+static const std::vector<std::string> corpus = {
+    "0", "42", "-17", "+3.25", "6.02e23", "1E-9", ".5", "12.", "0x1F", "0xdeadBEEF", "0o755", "0o8",
+    ".inf", "-.Inf", ".NaN", "1_000", "1e", "--1", "0x", "v1.2.3",
+    "2024-04-09", "1939-09-01", "20240409", "2024-W15", "2024-W15-2", "2024-100", "2024-360",
+    "2024-04-09T10:30", "2024-04-09T10:30:15.25Z", "2024-04-09 10:30:15+02:00", "2024-04-09T24:00",
+    "2024-04-09T1030", "2024-13-01", "2024-04-32", "2024 - 02 - 17",
+    "files", "posts", "Nyheter", "collection", "_nyheter", "rich-text", "unquoted value", "Elias Wennerlund",
+    "Lorem ipsum dolor sit amet", "true", "null", "~", "",
+};
+
+int RunClassifierBenchmark() {
+    // The scanners must accept exactly what the regexes accept
+    size_t mismatches = 0;
+    for (const std::string& value : corpus) {
+        if (YamlParser::IsNumber(value) != reference::IsNumber(value)) {
+            std::printf("IsNumber mismatch: '%s'\n", value.c_str());
+            mismatches++;
+        }
+        if (YamlParser::IsTimestamp(value) != reference::IsTimestamp(value)) {
+            std::printf("IsTimestamp mismatch: '%s'\n", value.c_str());
+            mismatches++;
+        }
+    }
+
+    if (mismatches > 0)
+        return 1;
+
+    const size_t regexRounds = 20;
+    const size_t scannerRounds = 20000;
+
+    struct Row {
+        const char* name;
+        bool (*regex)(const std::string&);
+        bool (*scanner)(std::string_view);
+    };
+
+    const Row rows[] = {
+        { "IsNumber", reference::IsNumber, YamlParser::IsNumber },
+        { "IsTimestamp", reference::IsTimestamp, YamlParser::IsTimestamp },
+    };
+
+    std::printf("%-12s %16s %16s %10s\n", "classifier", "regex ns/call", "scanner ns/call", "speedup");
+
+    for (const Row& row : rows) {
+        double regexNs = benchmark::MeasureNanoseconds(regexRounds, [&] {
+            for (const std::string& value : corpus)
+                benchmark::DoNotOptimize(row.regex(value));
+        }) / corpus.size();
+
+        double scannerNs = benchmark::MeasureNanoseconds(scannerRounds, [&] {
+            for (const std::string& value : corpus)
+                benchmark::DoNotOptimize(row.scanner(value));
+        }) / corpus.size();
+
+        std::printf("%-12s %16.1f %16.1f %9.0fx\n", row.name, regexNs, scannerNs, regexNs / scannerNs);
+    }
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include "Benchmark.h"
+#include "CorpusGenerator.h"
+
+#include <cstdio>
+#include <string>
+
+/// The schema of the README example, which the generated documents match.
+static Schema BlogSchema() {
+    return Schema(Schema::CreateObject({
+        { "media", Schema::String },
+        { "content", Schema::CreateArray(Schema::CreateObject({
+            { "name", Schema::String },
+            { "label", Schema::String },
+            { "type", Schema::String },
+            { "path", Schema::String },
+            { "fields", Schema::CreateArray(Schema::CreateObject({
+                { "name", Schema::String },
+                { "label", Schema::String },
+                { "type", Schema::Either(Schema::String, Schema::Number) },
+                { "hidden", Schema::Boolean },
+                { "default", Schema::Either(Schema::String, Schema::Null) },
+                { "date", Schema::Timestamp },
+                { "options", Schema::CreateObject({ { "maxlength", Schema::Number } }) },
+            })) },
+        })) },
+    }));
+}
+
+int RunCorpusBenchmark() {
+    Schema schema = BlogSchema();
+
+    if (!benchmark::jsonOutput)
+        std::printf("%-6s %8s %12s %14s %12s\n", "style", "MB", "valid MB/s", "mismatch MB/s", "syntax MB/s");
+
+    for (CorpusGenerator::Style style : { CorpusGenerator::BlockStyle, CorpusGenerator::FlowStyle }) {
+        for (size_t targetBytes : { 1u << 20, 16u << 20 }) {
+            CorpusGenerator::Options options;
+            options.targetBytes = targetBytes;
+            options.style = style;
+            options.keyProbability = 0.8;
+            options.extraKeys = 1;
+
+            CorpusGenerator generator(schema, options);
+            const CorpusGenerator::Sample valid = generator.Next();
+            const CorpusGenerator::Sample mismatch = generator.Next(CorpusGenerator::TypeMismatchDefect);
+            const CorpusGenerator::Sample syntax = generator.Next(CorpusGenerator::SyntaxDefect);
+
+            double ns[3] = {};
+            const CorpusGenerator::Sample* samples[3] = { &valid, &mismatch, &syntax };
+
+            for (size_t i = 0; i < 3; i++) {
+                const std::string_view yaml = samples[i]->yaml;
+                const bool expected = i == 0;
+
+                if (std::holds_alternative<Schema::ValidationResult::ValidationSuccess>(schema.ValidateText(yaml).result) != expected) {
+                    std::printf("%zu bytes: a generated document did not validate as expected\n", targetBytes);
+                    return 1;
+                }
+
+                // With no room for errors, a broken document is still reported as invalid
+                Schema::CollectOptions uncollected;
+                uncollected.maxErrors = 0;
+
+                if (schema.ValidateAllText(yaml, uncollected).IsValid() != expected) {
+                    std::printf("%zu bytes: a generated document did not validate as expected with maxErrors = 0\n", targetBytes);
+                    return 1;
+                }
+
+                ns[i] = benchmark::MeasureNanoseconds(3, [&] {
+                    benchmark::DoNotOptimize(schema.ValidateText(yaml).result.index());
+                });
+            }
+
+            const char* name = style == CorpusGenerator::BlockStyle ? "block" : "flow";
+            auto megabytesPerSecond = [](const CorpusGenerator::Sample& sample, double ns) { return sample.yaml.size() / 1e6 / (ns / 1e9); };
+
+            if (benchmark::jsonOutput) {
+                std::printf("{\"benchmark\": \"corpus\", \"style\": \"%s\", \"bytes\": %zu, \"valid_mb_per_s\": %.2f, "
+                            "\"mismatch_mb_per_s\": %.2f, \"syntax_mb_per_s\": %.2f, \"mismatch_line\": %ld, \"syntax_line\": %ld}\n",
+                    name, valid.yaml.size(), megabytesPerSecond(valid, ns[0]), megabytesPerSecond(mismatch, ns[1]),
+                    megabytesPerSecond(syntax, ns[2]), mismatch.line, syntax.line);
+            }
+            else {
+                std::printf("%-6s %8.2f %12.1f %14.1f %12.1f\n", name, valid.yaml.size() / 1e6, megabytesPerSecond(valid, ns[0]),
+                    megabytesPerSecond(mismatch, ns[1]), megabytesPerSecond(syntax, ns[2]));
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include "Benchmark.h"
+#include "Schema.h"
+
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// Number of fields in the body of each entry.
+static constexpr size_t Fields = 16;
+
+/**
+ * @brief Builds the schema of a list of entries of several kinds, told apart by their `type` key.
+ * @param kinds Number of kinds. The body of kind k has field k as a Number and every other field as a String.
+ * @param discriminate Whether the Either picks the kind by the value of `type`.
+ * @return The schema.
+ */
+static Schema EntriesSchema(size_t kinds, bool discriminate) {
+    std::vector<Schema::SchemaValue> alternatives;
+    std::unordered_map<std::string, size_t> mapping;
+
+    for (size_t k = 0; k < kinds; k++) {
+        std::unordered_map<std::string, Schema::SchemaValue> body;
+        for (size_t f = 0; f < Fields; f++)
+            body.emplace("f" + std::to_string(f), f == k ? Schema::Number : Schema::String);
+
+        alternatives.emplace_back(Schema::CreateObject({
+            { "type", Schema::String },
+            { "body", Schema::CreateObject(body) },
+        }));
+        mapping.emplace("kind" + std::to_string(k), k);
+    }
+
+    Schema::Either either(std::move(alternatives));
+    if (discriminate)
+        either.Discriminate("type", mapping);
+
+    return Schema(Schema::CreateObject({ { "entries", Schema::CreateArray(either) } }));
+}
+
+/**
+ * @brief Builds a document with entries of every kind in turn.
+ * @param kinds Number of kinds.
+ * @param entries Number of entries.
+ * @return The document.
+ */
+static std::string EntriesDocument(size_t kinds, size_t entries) {
+    std::string yaml = "entries:\n";
+
+    for (size_t i = 0; i < entries; i++) {
+        const size_t k = i % kinds;
+        yaml += "  - type: kind" + std::to_string(k) + "\n    body:\n";
+
+        for (size_t f = 0; f < Fields; f++)
+            yaml += "      f" + std::to_string(f) + ": " + (f == k ? "42" : "text") + "\n";
+    }
+
+    return yaml;
+}
+
+int RunEitherBenchmark() {
+    if (!benchmark::jsonOutput)
+        std::printf("%6s %8s %16s %16s %9s\n", "kinds", "MB", "in turn MB/s", "discrim. MB/s", "speedup");
+
+    for (size_t kinds : { 2, 4, 8, 16 }) {
+        const std::string yaml = EntriesDocument(kinds, 20000);
+        const ParserResult parsed = ParseYamlText(yaml);
+
+        if (parsed.IsError()) {
+            std::printf("%zu kinds: the document does not parse\n", kinds);
+            return 1;
+        }
+
+        double ns[2] = {};
+
+        for (bool discriminate : { false, true }) {
+            const Schema schema = EntriesSchema(kinds, discriminate);
+
+            if (!std::holds_alternative<Schema::ValidationResult::ValidationSuccess>(Schema::Validate(parsed.GetResult(), schema.GetCompiled()).result)) {
+                std::printf("%zu kinds: the document does not validate\n", kinds);
+                return 1;
+            }
+
+            ns[discriminate] = benchmark::MeasureNanoseconds(5, [&] {
+                benchmark::DoNotOptimize(Schema::Validate(parsed.GetResult(), schema.GetCompiled()).result.index());
+            });
+        }
+
+        const double megabytes = yaml.size() / 1e6;
+
+        if (benchmark::jsonOutput) {
+            std::printf("{\"benchmark\": \"either\", \"kinds\": %zu, \"bytes\": %zu, \"in_turn_mb_per_s\": %.2f, \"discriminated_mb_per_s\": %.2f}\n",
+                kinds, yaml.size(), megabytes / (ns[0] / 1e9), megabytes / (ns[1] / 1e9));
+        }
+        else {
+            std::printf("%6zu %8.2f %16.1f %16.1f %8.1fx\n", kinds, megabytes, megabytes / (ns[0] / 1e9), megabytes / (ns[1] / 1e9), ns[0] / ns[1]);
+        }
+    }
+
+    return 0;
+}
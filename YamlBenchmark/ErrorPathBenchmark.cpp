@@ -0,0 +1,204 @@
+#include "Benchmark.h"
+#include "YamlParser.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// A work-in-progress config file of a few kilobytes, as pre-commit hooks see them.
+static std::string ValidDocument(size_t seed) {
+    std::string yaml = "name: service-" + std::to_string(seed) + "\n";
+    yaml += "owners: [platform, \"on-call <oncall@example.com>\"]\n";
+    yaml += "routes:\n";
+
+    for (size_t i = 0; i < 20; i++) {
+        yaml += "  - path: /api/v1/resource" + std::to_string(i) + "\n";
+        yaml += "    method: GET\n";
+        yaml += "    timeout: " + std::to_string(100 + i * 10) + "\n";
+        yaml += "    retries: " + std::to_string(i % 4) + "\n";
+        yaml += "    description: 'Returns resource " + std::to_string(i) + " with its links expanded'\n";
+    }
+    return yaml;
+}
+
+/**
+ * @brief Breaks a valid document the way unfinished edits do.
+ * @param yaml A document from ValidDocument.
+ * @param seed Selects the kind of mistake and where it is made.
+ */
+static std::string InvalidDocument(std::string yaml, size_t seed) {
+    // Somewhere past the first few lines, so some of the document is parsed first
+    const size_t line = yaml.find("    retries:", yaml.size() / 4 + (seed * 131) % (yaml.size() / 2));
+
+    switch (seed % 4) {
+    case 0: // Unterminated quote
+        return yaml.substr(0, yaml.find('\'', line) + 10);
+    case 1: // Bad indentation
+        return yaml.insert(line, " ");
+    case 2: // Duplicate key
+        return yaml.insert(line, "    method: POST\n");
+    default: // Stray quote after the number of retries
+        return yaml.insert(line + 14, "\"");
+    }
+}
+
+/// Handler that ignores every event.
+class IgnoringHandler : public YamlEventHandler {
+public:
+    bool BeginObject(SourcePosition) override { return true; }
+    bool Key(std::string_view, SourcePosition) override { return true; }
+    bool EndObject(SourcePosition) override { return true; }
+    bool BeginArray(SourcePosition) override { return true; }
+    bool EndArray(SourcePosition) override { return true; }
+    bool Scalar(const YamlValue&, SourcePosition) override { return true; }
+};
+
+/// Rejects every document at its first number, by returning Fail.
+class FailingHandler : public IgnoringHandler {
+public:
+    bool Scalar(const YamlValue& value, SourcePosition) override {
+        return !std::holds_alternative<Number>(value) || Fail(ErrorType::InvalidScalarError);
+    }
+};
+
+/// Rejects every document at its first number, by throwing.
+class ThrowingHandler : public IgnoringHandler {
+public:
+    bool Scalar(const YamlValue& value, SourcePosition) override {
+        if (std::holds_alternative<Number>(value))
+            throw ErrorType::InvalidScalarError;
+        return true;
+    }
+};
+
+/**
+ * @struct Latencies
+ * @brief Time per document, sorted.
+ */
+struct Latencies {
+    std::vector<double> ns;
+
+    double Percentile(double p) const {
+        return ns.empty() ? 0 : ns[std::min(ns.size() - 1, static_cast<size_t>(p * ns.size()))];
+    }
+};
+
+/**
+ * @brief Parses every document of the corpus once per round on each of threads threads.
+ * @param parse Callable taking a std::string_view and returning true if the result was as expected.
+ * @return The latency of every parse, or an empty list if any result was not as expected.
+ */
+template<typename F>
+static Latencies Run(const std::vector<std::string>& corpus, unsigned threads, size_t rounds, F parse) {
+    std::vector<std::vector<double>> perThread(threads);
+    std::vector<std::thread> workers;
+    std::atomic<bool> unexpected = false;
+
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            perThread[t].reserve(corpus.size() * rounds);
+
+            for (size_t round = 0; round < rounds; round++) {
+                for (const std::string& yaml : corpus) {
+                    auto start = std::chrono::steady_clock::now();
+                    bool expected = parse(std::string_view(yaml));
+                    auto elapsed = std::chrono::steady_clock::now() - start;
+
+                    perThread[t].push_back(std::chrono::duration<double, std::nano>(elapsed).count());
+                    if (!expected)
+                        unexpected = true;
+                }
+            }
+        });
+    }
+
+    for (std::thread& worker : workers)
+        worker.join();
+
+    Latencies latencies;
+    if (unexpected)
+        return latencies;
+
+    for (std::vector<double>& ns : perThread)
+        latencies.ns.insert(latencies.ns.end(), ns.begin(), ns.end());
+
+    std::sort(latencies.ns.begin(), latencies.ns.end());
+    return latencies;
+}
+
+int RunErrorPathBenchmark() {
+    const size_t documents = 2000;
+    const size_t rounds = 5;
+
+    std::vector<std::string> valid;
+    std::vector<std::string> invalid;
+
+    for (size_t i = 0; i < documents; i++) {
+        valid.push_back(ValidDocument(i));
+        invalid.push_back(InvalidDocument(valid.back(), i));
+    }
+
+    // A repeated key is reported where it starts, not where the parser stopped after it
+    for (size_t i = 2; i < documents; i += 4) {
+        const size_t offset = invalid[i].find("    method: POST\n");
+        const long line = 1 + static_cast<long>(std::count(invalid[i].begin(), invalid[i].begin() + offset, '\n'));
+        const std::optional<ParserError> error = ParseYamlText(invalid[i], ViewInput).GetIfError();
+
+        if (!error.has_value() || error->error != ErrorType::DuplicateKeyError || error->line != line || error->column != 5) {
+            std::printf("duplicate key: the error is not reported at %ld:5\n", line);
+            return 1;
+        }
+    }
+
+    struct Case {
+        const char* name;
+        const std::vector<std::string>& corpus;
+        bool (*parse)(std::string_view yaml);
+    };
+
+    // Building the document, as validation does, and with a handler that rejects
+    // every document with Fail or with an exception at the same point
+    const Case cases[] = {
+        { "valid", valid, [](std::string_view yaml) {
+            return !ParseYamlText(yaml, ViewInput).GetIfError().has_value();
+        } },
+        { "invalid", invalid, [](std::string_view yaml) {
+            return ParseYamlText(yaml, ViewInput).GetIfError().has_value();
+        } },
+        { "fail", valid, [](std::string_view yaml) {
+            FailingHandler handler;
+            return ParseYamlText(yaml, handler).has_value();
+        } },
+        { "throw", valid, [](std::string_view yaml) {
+            ThrowingHandler handler;
+            return ParseYamlText(yaml, handler).has_value();
+        } },
+    };
+
+    const unsigned concurrent = std::max(4u, std::thread::hardware_concurrency());
+
+    std::printf("%-8s %7s %12s %10s %10s %10s\n", "corpus", "threads", "docs/s", "p50 us", "p99 us", "p99.9 us");
+
+    for (const Case& test : cases) {
+        for (unsigned threads : { 1u, concurrent }) {
+            auto start = std::chrono::steady_clock::now();
+            Latencies latencies = Run(test.corpus, threads, rounds, test.parse);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            if (latencies.ns.empty()) {
+                std::printf("%s: a document did not parse as expected\n", test.name);
+                return 1;
+            }
+
+            std::printf("%-8s %7u %12.0f %10.2f %10.2f %10.2f\n", test.name, threads, latencies.ns.size() / seconds,
+                latencies.Percentile(0.5) / 1e3, latencies.Percentile(0.99) / 1e3, latencies.Percentile(0.999) / 1e3);
+        }
+    }
+
+    return 0;
+}
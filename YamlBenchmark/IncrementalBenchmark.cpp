@@ -0,0 +1,94 @@
+#include "Benchmark.h"
+#include "IncrementalDocument.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/// A routing table with the given number of routes, about 150 bytes each.
+static std::string RoutesDocument(size_t routes) {
+    std::string yaml = "name: gateway\n";
+    yaml += "routes:\n";
+
+    for (size_t i = 0; i < routes; i++) {
+        yaml += "  - path: /api/v1/resource" + std::to_string(i) + "\n";
+        yaml += "    method: GET\n";
+        yaml += "    timeout: " + std::to_string(100 + i % 50 * 10) + "\n";
+        yaml += "    retries: " + std::to_string(i % 4) + "\n";
+        yaml += "    description: 'Returns resource " + std::to_string(i) + " with its links expanded'\n";
+    }
+    return yaml;
+}
+
+int RunIncrementalBenchmark() {
+    Schema schema(Schema::CreateObject({
+        { "name", Schema::String },
+        { "routes", Schema::CreateArray(Schema::CreateObject({
+            { "path", Schema::String },
+            { "method", Schema::String },
+            { "timeout", Schema::Number },
+            { "retries", Schema::Number },
+            { "description", Schema::String },
+        })) },
+    }));
+
+    const size_t edits = 400;
+
+    std::printf("%8s %10s %12s %12s %12s %14s\n", "routes", "MB", "full ms", "edit p50 us", "edit p99 us", "bytes/edit");
+
+    for (size_t routes : { 100, 1000, 10000, 100000 }) {
+        const std::string yaml = RoutesDocument(routes);
+
+        double fullNs = benchmark::MeasureNanoseconds(3, [&] {
+            benchmark::DoNotOptimize(schema.ValidateText(yaml).result.index());
+        });
+
+        IncrementalDocument document(yaml);
+        benchmark::DoNotOptimize(schema.Validate(document).result.index());
+
+        // Typing into, and deleting from, the description of the route in the middle.
+        // Every other keystroke makes the timeout a string, so the result flips as well.
+        const size_t description = yaml.find("Returns resource " + std::to_string(routes / 2) + " ");
+        const size_t timeout = yaml.rfind("timeout: ", description) + 9;
+        const IncrementalDocument::Statistics before = document.GetStatistics();
+
+        std::vector<double> ns;
+        ns.reserve(edits);
+
+        for (size_t i = 0; i < edits; i++) {
+            auto start = std::chrono::steady_clock::now();
+
+            if (i % 4 == 0)
+                document.Edit(description + 8, 0, "x");
+            else if (i % 4 == 1)
+                document.Edit(timeout + 1, 0, "s");
+            else if (i % 4 == 2)
+                document.Edit(timeout + 1, 1, "");
+            else
+                document.Edit(description + 8, 1, "");
+
+            bool valid = std::holds_alternative<Schema::ValidationResult::ValidationSuccess>(schema.Validate(document).result);
+            ns.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+
+            if (valid != (i % 4 != 1)) {
+                std::printf("%zu routes: edit %zu did not validate as expected\n", routes, i);
+                return 1;
+            }
+        }
+
+        if (document.GetText() != yaml) {
+            std::printf("%zu routes: the edits did not restore the text\n", routes);
+            return 1;
+        }
+
+        std::sort(ns.begin(), ns.end());
+        const IncrementalDocument::Statistics after = document.GetStatistics();
+
+        std::printf("%8zu %10.2f %12.2f %12.2f %12.2f %14.0f\n", routes, yaml.size() / 1e6, fullNs / 1e6,
+            ns[ns.size() / 2] / 1e3, ns[ns.size() * 99 / 100] / 1e3, static_cast<double>(after.parsedBytes - before.parsedBytes) / edits);
+    }
+
+    return 0;
+}
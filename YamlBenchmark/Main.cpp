@@ -0,0 +1,62 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstring>
+
+struct BenchmarkEntry {
+    const char* name;   /// Name used to select the benchmark on the command line.
+    int (*run)();       /// Runs the benchmark and returns the process exit code.
+};
+
+static const BenchmarkEntry benchmarks[] = {
+    { "classifiers", RunClassifierBenchmark },
+    { "structural", RunStructuralIndexBenchmark },
+    { "errors", RunErrorPathBenchmark },
+    { "incremental", RunIncrementalBenchmark },
+    { "suite", RunSuiteBenchmark },
+    { "corpus", RunCorpusBenchmark },
+    { "either", RunEitherBenchmark },
+};
+
+int main(int argc, char* argv[]) {
+    int exitCode = 0;
+    int names = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--json") == 0) {
+            benchmark::jsonOutput = true;
+            continue;
+        }
+
+        // A mistyped name would otherwise run nothing and still succeed
+        bool known = false;
+        for (const BenchmarkEntry& entry : benchmarks)
+            known = known || std::strcmp(argv[i], entry.name) == 0;
+
+        if (!known) {
+            std::fprintf(stderr, "Unknown benchmark '%s'. Valid names:", argv[i]);
+            for (const BenchmarkEntry& entry : benchmarks)
+                std::fprintf(stderr, " %s", entry.name);
+            std::fprintf(stderr, "\n");
+            return 1;
+        }
+
+        names++;
+    }
+
+    for (const BenchmarkEntry& entry : benchmarks) {
+        // Without names every benchmark runs, otherwise only the named ones
+        bool selected = names == 0;
+        for (int i = 1; i < argc; i++)
+            selected = selected || std::strcmp(argv[i], entry.name) == 0;
+
+        if (!selected)
+            continue;
+
+        if (!benchmark::jsonOutput)
+            std::printf("== %s\n", entry.name);
+        exitCode |= entry.run();
+    }
+
+    return exitCode;
+}
@@ -0,0 +1,136 @@
+#include "Benchmark.h"
+#include "StructuralIndex.h"
+#include "YamlParser.h"
+
+#include <cstdio>
+#include <string>
+
+/// Handler that ignores every event, so only the parser itself is measured.
+class NullHandler : public YamlEventHandler {
+public:
+    size_t events = 0;
+
+    bool BeginObject(SourcePosition) override { events++; return true; }
+    bool Key(std::string_view, SourcePosition) override { events++; return true; }
+    bool EndObject(SourcePosition) override { events++; return true; }
+    bool BeginArray(SourcePosition) override { events++; return true; }
+    bool EndArray(SourcePosition) override { events++; return true; }
+    bool Scalar(const YamlValue&, SourcePosition) override { events++; return true; }
+};
+
+/// A block-style list of objects with prose, quoted strings, numbers and dates.
+static std::string BlockInput(size_t items) {
+    std::string yaml = "items:\n";
+
+    for (size_t i = 0; i < items; i++) {
+        yaml += "  - title: Lorem ipsum dolor sit amet consectetur adipiscing elit " + std::to_string(i) + "\n";
+        yaml += "    author: \"Elias Wennerlund <elias@example.com>, editor\"\n";
+        yaml += "    published: 2024-04-09\n";
+        yaml += "    votes: " + std::to_string(i * 7) + "\n";
+        yaml += "    summary: 'A somewhat longer summary that spans most of a line, as real posts do'\n";
+    }
+    return yaml;
+}
+
+/// The same items as BlockInput, written as one flow-style array.
+static std::string FlowInput(size_t items) {
+    std::string yaml = "[";
+
+    for (size_t i = 0; i < items; i++) {
+        if (i > 0)
+            yaml += ",\n";
+
+        yaml += "{title: Lorem ipsum dolor sit amet consectetur adipiscing elit " + std::to_string(i);
+        yaml += ", author: \"Elias Wennerlund <elias@example.com>, editor\"";
+        yaml += ", published: 2024-04-09, votes: " + std::to_string(i * 7);
+        yaml += ", summary: 'A somewhat longer summary that spans most of a line, as real posts do'}";
+    }
+    return yaml + "]";
+}
+
+/// Counts the characters of a set one byte at a time, the way the parser looked at them before.
+static size_t CountWithFind(std::string_view input, const std::string& chars) {
+    size_t count = 0;
+    for (char c : input)
+        count += chars.find(c) != std::string::npos;
+    return count;
+}
+
+static size_t CountWithIndex(std::string_view input, StructuralIndex::CharacterSet set) {
+    StructuralIndex index(input);
+    size_t count = 0;
+
+    for (const char* next = index.Next(input.data(), set); next != input.data() + input.size(); next = index.Next(next + 1, set))
+        count++;
+    return count;
+}
+
+int RunStructuralIndexBenchmark() {
+    const size_t items = 100000;
+    const size_t rounds = 5;
+
+    struct Input {
+        const char* name;
+        std::string yaml;
+    };
+
+    const Input inputs[] = {
+        { "block", BlockInput(items) },
+        { "flow", FlowInput(items) },
+    };
+
+    struct Set {
+        const char* name;
+        StructuralIndex::CharacterSet set;
+        std::string chars; /// The same characters as set.
+    };
+
+    // Unquoted is what the parser looks for in most scalars and keys, it stops at every space.
+    // Quoted rarely matches, so it shows how fast the input itself is classified.
+    const Set sets[] = {
+        { "unquoted", StructuralIndex::Unquoted, "\n !\"#%&'*,:<=>?@[\\]{|}" },
+        { "quoted", StructuralIndex::Quoted, "\n\"'\\" },
+    };
+
+    std::printf("%-6s %-9s %8s %12s %12s\n", "input", "set", "MB", "find GB/s", "index GB/s");
+
+    for (const Input& input : inputs) {
+        for (const Set& set : sets) {
+            if (CountWithFind(input.yaml, set.chars) != CountWithIndex(input.yaml, set.set)) {
+                std::printf("%s: the index disagrees with std::string::find for %s\n", input.name, set.name);
+                return 1;
+            }
+
+            double findNs = benchmark::MeasureNanoseconds(rounds, [&] {
+                benchmark::DoNotOptimize(CountWithFind(input.yaml, set.chars));
+            });
+
+            double indexNs = benchmark::MeasureNanoseconds(rounds, [&] {
+                benchmark::DoNotOptimize(CountWithIndex(input.yaml, set.set));
+            });
+
+            std::printf("%-6s %-9s %8.1f %12.2f %12.2f\n", input.name, set.name, input.yaml.size() / 1e6,
+                input.yaml.size() / findNs, input.yaml.size() / indexNs);
+        }
+    }
+
+    std::printf("\n%-6s %12s %12s\n", "input", "parse MB/s", "events/s");
+
+    for (const Input& input : inputs) {
+        NullHandler handler;
+        bool failed = false;
+
+        double parseNs = benchmark::MeasureNanoseconds(rounds, [&] {
+            failed = failed || ParseYamlText(input.yaml, handler).has_value();
+        });
+
+        if (failed) {
+            std::printf("%s: the input did not parse\n", input.name);
+            return 1;
+        }
+
+        std::printf("%-6s %12.1f %12.3g\n", input.name, input.yaml.size() * 1e3 / parseNs, handler.events * 1e9 / rounds / parseNs);
+    }
+
+    return 0;
+}
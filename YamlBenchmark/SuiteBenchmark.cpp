@@ -0,0 +1,351 @@
+#include "Benchmark.h"
+#include "Schema.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#include <malloc.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace parser_types;
+
+/// Every allocation of the benchmark executable, including the arena blocks of each Document.
+static std::atomic<uint64_t> allocations = 0;
+
+/// Bytes the benchmark executable has allocated and not freed yet.
+static std::atomic<uint64_t> liveBytes = 0;
+
+/// The most bytes that were live at once since the last ResetPeakBytes.
+static std::atomic<uint64_t> peakBytes = 0;
+
+/// Room in front of each allocation for its size, kept at the alignment operator new guarantees.
+static constexpr std::size_t Header = alignof(std::max_align_t);
+
+/**
+ * @brief Counts an allocation and its size, and records the size in front of the memory handed out.
+ * @param base The memory from malloc, with header bytes in front of the size requested.
+ * @param header Bytes in front of the memory handed out, at least sizeof(std::size_t).
+ * @param size The size requested.
+ * @return The memory handed out.
+ */
+static void* Track(void* base, std::size_t header, std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    const uint64_t live = liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    uint64_t peak = peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+
+    char* memory = static_cast<char*>(base) + header;
+    std::memcpy(memory - sizeof(std::size_t), &size, sizeof(std::size_t));
+    return memory;
+}
+
+/**
+ * @brief Uncounts the size of an allocation made through Track.
+ * @param memory The memory handed out.
+ * @param header Bytes in front of it, as given to Track.
+ * @return The memory from malloc.
+ */
+static void* Untrack(void* memory, std::size_t header) {
+    std::size_t size;
+    std::memcpy(&size, static_cast<char*>(memory) - sizeof(std::size_t), sizeof(std::size_t));
+    liveBytes.fetch_sub(size, std::memory_order_relaxed);
+    return static_cast<char*>(memory) - header;
+}
+
+/// Starts measuring the peak again from the bytes that are live now, and returns them.
+static uint64_t ResetPeakBytes() {
+    const uint64_t live = liveBytes.load(std::memory_order_relaxed);
+    peakBytes.store(live, std::memory_order_relaxed);
+    return live;
+}
+
+void* operator new(std::size_t size) {
+    if (void* base = std::malloc(Header + size))
+        return Track(base, Header, size);
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    if (memory != nullptr)
+        std::free(Untrack(memory, Header));
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    operator delete(memory);
+}
+
+// std::pmr::new_delete_resource() allocates with an alignment, so Documents and parsers come through here
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    // A whole alignment in front keeps the memory handed out aligned
+    const std::size_t align = std::max(static_cast<std::size_t>(alignment), Header);
+#ifdef _WIN32
+    if (void* base = _aligned_malloc(align + size, align))
+        return Track(base, align, size);
+#else
+    if (void* base = std::aligned_alloc(align, (align + size + align - 1) / align * align))
+        return Track(base, align, size);
+#endif
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory, std::align_val_t alignment) noexcept {
+    if (memory == nullptr)
+        return;
+
+    void* base = Untrack(memory, std::max(static_cast<std::size_t>(alignment), Header));
+#ifdef _WIN32
+    _aligned_free(base);
+#else
+    std::free(base);
+#endif
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept {
+    operator delete(memory, alignment);
+}
+
+/// The most memory the process has had resident so far, in kilobytes. Unlike the peak heap, this
+/// includes the thread stacks, the allocator's own overhead and any mapped input.
+static uint64_t PeakResidentKilobytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return counters.PeakWorkingSetSize / 1024;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#endif
+}
+
+/// Counts the values of a document, containers included.
+static size_t CountNodes(const YamlValue& value) {
+    size_t nodes = 1;
+
+    if (Object* const* object = std::get_if<Object*>(&value)) {
+        for (const auto& [key, nested] : **object)
+            nodes += CountNodes(nested);
+    }
+    else if (Array* const* array = std::get_if<Array*>(&value)) {
+        for (const YamlValue& nested : **array)
+            nodes += CountNodes(nested);
+    }
+
+    return nodes;
+}
+
+/**
+ * @struct Shape
+ * @brief Struct representing one kind of document the suite measures.
+ */
+struct Shape {
+    const char* name;   /// Name in the output.
+    std::string yaml;   /// The document.
+    Schema schema;      /// A schema the document matches.
+};
+
+/// One object with many keys.
+static Shape WideObject() {
+    std::string yaml;
+    for (size_t i = 0; i < 100000; i++)
+        yaml += "key" + std::to_string(i) + ": value " + std::to_string(i) + "\n";
+
+    return { "wide-object", yaml, Schema(Schema::CreateObject({
+        { "key0", Schema::String },
+        { "key50000", Schema::String },
+        { "key99999", Schema::String },
+    })) };
+}
+
+/// One array with many short items.
+static Shape LongSequence() {
+    std::string yaml;
+    for (size_t i = 0; i < 300000; i++)
+        yaml += i % 2 == 0 ? "- " + std::to_string(i) + "\n" : "- item" + std::to_string(i) + "\n";
+
+    return { "long-sequence", yaml, Schema(Schema::CreateArray(Schema::Either(Schema::Number, Schema::String))) };
+}
+
+/// Records whose values are nested objects many levels deep.
+static Shape DeepNesting() {
+    const size_t depth = 32;
+
+    std::string yaml;
+    for (size_t record = 0; record < 2000; record++) {
+        yaml += "- ";
+        for (size_t level = 0; level < depth; level++)
+            yaml += (level == 0 ? "" : "\n" + std::string(2 * level + 2, ' ')) + "level" + std::to_string(level) + ":";
+        yaml += " leaf" + std::to_string(record) + "\n";
+    }
+
+    Schema::SchemaValue nested = Schema::String;
+    for (size_t level = depth; level-- > 0;)
+        nested = Schema::CreateObject({ { "level" + std::to_string(level), nested } });
+
+    return { "deep-nesting", yaml, Schema(Schema::CreateArray(nested)) };
+}
+
+/// The schema of the records of the block and flow shapes.
+static Schema RecordSchema() {
+    return Schema(Schema::CreateArray(Schema::CreateObject({
+        { "id", Schema::Number },
+        { "name", Schema::String },
+        { "tags", Schema::CreateArray(Schema::String) },
+        { "active", Schema::Boolean },
+    })));
+}
+
+/// Records in block style.
+static Shape BlockStyle() {
+    std::string yaml;
+    for (size_t i = 0; i < 40000; i++) {
+        yaml += "- id: " + std::to_string(i) + "\n";
+        yaml += "  name: record" + std::to_string(i) + "\n";
+        yaml += "  tags:\n    - alpha\n    - beta\n";
+        yaml += std::string("  active: ") + (i % 3 == 0 ? "false" : "true") + "\n";
+    }
+
+    return { "block-style", yaml, RecordSchema() };
+}
+
+/// The same records in flow style.
+static Shape FlowStyle() {
+    std::string yaml = "[";
+    for (size_t i = 0; i < 40000; i++) {
+        yaml += i == 0 ? "" : ", ";
+        yaml += "{id: " + std::to_string(i) + ", name: record" + std::to_string(i) + ", tags: [alpha, beta], active: ";
+        yaml += i % 3 == 0 ? "false}" : "true}";
+    }
+    yaml += "]\n";
+
+    return { "flow-style", yaml, RecordSchema() };
+}
+
+/// Records of numbers, timestamps, booleans and nulls, which all have to be classified.
+static Shape ScalarHeavy() {
+    std::string yaml;
+    for (size_t i = 0; i < 40000; i++) {
+        yaml += "- count: " + std::to_string(i * 7) + "\n";
+        yaml += "  ratio: " + std::to_string(i % 100) + ".25e-3\n";
+        yaml += "  hex: 0x" + std::to_string(1000 + i % 9000) + "\n";
+        yaml += "  at: 2024-0" + std::to_string(1 + i % 9) + "-1" + std::to_string(i % 10) + "\n";
+        yaml += std::string("  enabled: ") + (i % 2 == 0 ? "true" : "false") + "\n";
+        yaml += "  missing: null\n";
+    }
+
+    return { "scalar-heavy", yaml, Schema(Schema::CreateArray(Schema::CreateObject({
+        { "count", Schema::Number },
+        { "ratio", Schema::Number },
+        { "hex", Schema::Number },
+        { "at", Schema::Timestamp },
+        { "enabled", Schema::Boolean },
+        { "missing", Schema::Null },
+    }))) };
+}
+
+/// Records of quoted strings, some with escapes.
+static Shape QuoteHeavy() {
+    std::string yaml;
+    for (size_t i = 0; i < 40000; i++) {
+        yaml += "- single: 'it''s record " + std::to_string(i) + ", with: punctuation'\n";
+        yaml += "  double: \"tab\\there, newline\\nhere " + std::to_string(i) + "\"\n";
+        yaml += "  plain: \"" + std::to_string(i) + "\"\n";
+    }
+
+    return { "quote-heavy", yaml, Schema(Schema::CreateArray(Schema::CreateObject({
+        { "single", Schema::String },
+        { "double", Schema::String },
+        { "plain", Schema::String },
+    }))) };
+}
+
+/**
+ * @brief Runs the body for about a quarter of a second.
+ * @return The average time per call in nanoseconds, and the allocations per call.
+ */
+template<typename F>
+static std::pair<double, double> Measure(F&& body) {
+    const double once = benchmark::MeasureNanoseconds(1, body);
+    const size_t iterations = static_cast<size_t>(std::max(1.0, 250e6 / std::max(once, 1.0)));
+
+    const uint64_t before = allocations.load(std::memory_order_relaxed);
+    const double ns = benchmark::MeasureNanoseconds(iterations, body);
+    const uint64_t allocated = allocations.load(std::memory_order_relaxed) - before;
+
+    return { ns, static_cast<double>(allocated) / static_cast<double>(iterations) };
+}
+
+int RunSuiteBenchmark() {
+    std::vector<Shape (*)()> shapes = { WideObject, LongSequence, DeepNesting, BlockStyle, FlowStyle, ScalarHeavy, QuoteHeavy };
+
+    if (!benchmark::jsonOutput)
+        std::printf("%-14s %8s %10s %10s %12s %12s %14s %12s %13s %12s\n", "shape", "MB", "nodes", "parse MB/s", "Mnodes/s", "validate/s", "parse+valid/s", "allocs/doc", "peak heap MB", "peak RSS MB");
+
+    for (Shape (*create)() : shapes) {
+        // Everything the shape allocates counts, from its text to the documents it measures
+        const uint64_t baseline = ResetPeakBytes();
+        Shape shape = create();
+
+        ParserResult parsed = ParseYamlText(shape.yaml);
+        if (parsed.IsError() || !std::holds_alternative<Schema::ValidationResult::ValidationSuccess>(Schema::Validate(parsed.GetResult(), shape.schema.GetCompiled()).result)) {
+            std::printf("%s: the document does not parse or validate\n", shape.name);
+            return 1;
+        }
+
+        const Yaml root = parsed.GetResult();
+        const size_t nodes = std::visit([](const auto& node) { return CountNodes(YamlValue(node.get())); }, root);
+
+        auto [parseNs, parseAllocations] = Measure([&] {
+            benchmark::DoNotOptimize(ParseYamlText(shape.yaml).IsError());
+        });
+        auto [validateNs, validateAllocations] = Measure([&] {
+            benchmark::DoNotOptimize(Schema::Validate(root, shape.schema.GetCompiled()).result.index());
+        });
+        auto [bothNs, bothAllocations] = Measure([&] {
+            benchmark::DoNotOptimize(shape.schema.ValidateText(shape.yaml).result.index());
+        });
+
+        const double megabytes = static_cast<double>(shape.yaml.size()) / 1e6;
+        const uint64_t peak = peakBytes.load(std::memory_order_relaxed) - baseline;
+
+        // The process never gives back its peak, so shapes after a larger one report that one's
+        const uint64_t peakResident = PeakResidentKilobytes();
+
+        if (benchmark::jsonOutput) {
+            std::printf("{\"benchmark\": \"suite\", \"shape\": \"%s\", \"bytes\": %zu, \"nodes\": %zu, "
+                        "\"parse_mb_per_s\": %.2f, \"parse_nodes_per_s\": %.0f, \"validate_docs_per_s\": %.2f, "
+                        "\"parse_validate_docs_per_s\": %.2f, \"parse_allocations_per_doc\": %.1f, "
+                        "\"validate_allocations_per_doc\": %.1f, \"parse_validate_allocations_per_doc\": %.1f, \"peak_heap_bytes\": %llu, \"peak_rss_kb\": %llu}\n",
+                shape.name, shape.yaml.size(), nodes, megabytes / (parseNs / 1e9), nodes / (parseNs / 1e9), 1e9 / validateNs,
+                1e9 / bothNs, parseAllocations, validateAllocations, bothAllocations, static_cast<unsigned long long>(peak),
+                static_cast<unsigned long long>(peakResident));
+        }
+        else {
+            std::printf("%-14s %8.2f %10zu %10.1f %12.2f %12.1f %14.1f %12.1f %13.1f %12.1f\n", shape.name, megabytes, nodes,
+                megabytes / (parseNs / 1e9), nodes / (parseNs / 1e3), 1e9 / validateNs, 1e9 / bothNs, bothAllocations, peak / 1e6,
+                peakResident * 1024 / 1e6);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include "Schema.h"
+#include "InputSource.h"
+#include "ThreadPool.h"
+#include "ValidationCache.h"
+
+#include <algorithm>
+#include <memory_resource>
+
+Schema::ValidationResult Schema::ValidateFile(const std::filesystem::path& path, const CompiledSchema& compiled, std::shared_ptr<std::pmr::memory_resource> upstream, ValidationCache* cache, ThreadPool* pool, size_t grainSize) {
+    uint64_t io = 0;
+    std::optional<InputSource> source;
+    {
+        PhaseTimer timer(io);
+        source = InputSource::FromFile(path.string());
+    }
+
+    if (!source.has_value())
+        return ValidationResult(ValidationResult::ValidationError(ParserError(::ErrorType::FileOpenError, 0, 0)));
+
+    const std::string_view input = source->View();
+
+    ValidationCache::Key key = {};
+
+    if (cache != nullptr) {
+        key = { ValidationCache::Hash(input), input.size(), compiled.fingerprint };
+
+        if (std::optional<std::string> entry = cache->Load(key)) {
+            if (std::optional<ValidationResult> cached = DecodeResult(compiled, entry.value()))
+                return std::move(cached.value());
+        }
+    }
+
+    // The result may outlive the file, so unlike streaming validation the document copies its scalars
+    // and the file is unmapped when this returns. See ParseYaml(const std::string&, ScalarStorage).
+    YamlParser parser(input, CopyScalars);
+    parser.SetUpstreamResource(std::move(upstream));
+    parser.GetStatistics().ioNanoseconds += io;
+
+    ParserResult parsed = parser.Parse();
+
+    ValidationResult result = ValidationResult(ValidationResult::ValidationSuccess());
+
+    if (std::optional<ParserError> error = parsed.GetIfError())
+        result = ValidationResult(ValidationResult::ValidationError(error.value()));
+    else if (pool != nullptr)
+        result = Validate(parsed.GetResult(), compiled, *pool, grainSize);
+    else
+        result = Validate(parsed.GetResult(), compiled);
+
+    if (cache != nullptr)
+        cache->Store(key, EncodeResult(compiled, result));
+
+    result.AddStatistics(parsed.GetStatistics());
+
+    return result;
+}
+
+std::vector<Schema::ValidationResult> Schema::ValidateFiles(std::span<const std::filesystem::path> paths, const BatchOptions& options) const {
+    if (paths.empty())
+        return {};
+
+    unsigned workers = options.workers != 0 ? options.workers : std::max(1u, std::thread::hardware_concurrency());
+    workers = static_cast<unsigned>(std::min<size_t>(workers, paths.size()));
+
+    ThreadPool pool(workers);
+
+    // One arena pool per worker, and one for the calling thread, which runs tasks while it waits.
+    // Results may release their Document on any thread later on, so the pools are synchronized,
+    // but each is only ever contended by the worker that owns it and whoever drops a result.
+    std::vector<std::shared_ptr<std::pmr::memory_resource>> arenas(pool.WorkerCount() + 1);
+
+    if (options.perThreadArenas) {
+        const std::pmr::pool_options poolOptions = { 0, 1 << 20 };
+
+        for (std::shared_ptr<std::pmr::memory_resource>& arena : arenas)
+            arena = std::make_shared<std::pmr::synchronized_pool_resource>(poolOptions);
+    }
+
+    const CompiledSchema& schema = *compiled;
+    std::vector<std::optional<ValidationResult>> results(paths.size());
+
+    ThreadPool::TaskGroup group(pool);
+
+    for (size_t i = 0; i < paths.size(); i++) {
+        group.Run([&, i] {
+            results[i] = ValidateFile(paths[i], schema, arenas[pool.CurrentWorker()], cache.get());
+        });
+    }
+
+    group.Wait();
+
+    std::vector<ValidationResult> ordered;
+    ordered.reserve(results.size());
+
+    for (std::optional<ValidationResult>& result : results)
+        ordered.push_back(std::move(result.value()));
+
+    return ordered;
+}
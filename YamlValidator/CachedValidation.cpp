@@ -0,0 +1,210 @@
+#include "Schema.h"
+
+#include <cstring>
+
+/// Bumped whenever the layout written by EncodeResult changes, so older entries are misses.
+static constexpr uint8_t resultFormat = 1;
+
+/**
+ * @enum StoredOutcome
+ * @brief Enum representing which kind of ValidationResult an encoded result holds.
+ */
+enum StoredOutcome : uint8_t {
+    StoredSuccess,
+    StoredParserError,
+    StoredSchemaError,
+};
+
+/**
+ * @enum StoredLocation
+ * @brief Enum representing which kind of information an encoded SchemaError holds.
+ */
+enum StoredLocation : uint8_t {
+    StoredNowhere,
+    StoredArray,
+    StoredObject,
+};
+
+template<typename T>
+static void Put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/**
+ * @struct StoredReader
+ * @brief Reads the fields written by Put back, failing once the bytes run out.
+ */
+struct StoredReader {
+    std::string_view bytes;             /// The bytes that have not been read yet.
+
+    template<typename T>
+    bool Get(T& value) {
+        if (bytes.size() < sizeof(value))
+            return false;
+
+        std::memcpy(&value, bytes.data(), sizeof(value));
+        bytes.remove_prefix(sizeof(value));
+        return true;
+    }
+
+    bool Get(std::string& value, size_t size) {
+        if (bytes.size() < size)
+            return false;
+
+        value.assign(bytes.substr(0, size));
+        bytes.remove_prefix(size);
+        return true;
+    }
+};
+
+/**
+ * @brief Compares two SchemaValues the way the compiled schema sees them.
+ * @note Arrays and objects are equal if they are the same implementation, Eithers if their alternatives are.
+ */
+static bool SameSchemaValue(const Schema::SchemaValue& a, const Schema::SchemaValue& b) {
+    if (a.index() != b.index())
+        return false;
+
+    return std::visit([&b](const auto& value) {
+        using T = std::decay_t<decltype(value)>;
+        const T& other = std::get<T>(b);
+
+        if constexpr (std::is_same_v<T, Schema::Either>) {
+            if (value.GetValues().size() != other.GetValues().size())
+                return false;
+
+            for (size_t i = 0; i < value.GetValues().size(); i++) {
+                if (!SameSchemaValue(value.GetValues()[i], other.GetValues()[i]))
+                    return false;
+            }
+            return true;
+        }
+        else {
+            return value == other;
+        }
+    }, a);
+}
+
+std::string Schema::EncodeResult(const CompiledSchema& compiled, const ValidationResult& result) {
+    std::string out;
+    Put(out, resultFormat);
+
+    const ValidationResult::ValidationError* error = std::get_if<ValidationResult::ValidationError>(&result.result);
+
+    if (error == nullptr) {
+        Put(out, StoredSuccess);
+        return out;
+    }
+
+    if (const ParserError* parserError = std::get_if<ParserError>(&error->error)) {
+        Put(out, StoredParserError);
+        Put(out, static_cast<uint32_t>(parserError->error));
+        Put(out, static_cast<int64_t>(parserError->line));
+        Put(out, static_cast<int64_t>(parserError->column));
+        return out;
+    }
+
+    const SchemaError& schemaError = std::get<SchemaError>(error->error);
+    Put(out, StoredSchemaError);
+    Put(out, static_cast<uint32_t>(schemaError.errorType));
+
+    if (!schemaError.information.has_value()) {
+        Put(out, StoredNowhere);
+    }
+    else if (const SchemaError::ArrayError* arrayError = std::get_if<SchemaError::ArrayError>(&schemaError.information.value())) {
+        Put(out, StoredArray);
+        Put(out, arrayError->index.has_value());
+        Put(out, static_cast<int32_t>(arrayError->index.value_or(0)));
+    }
+    else {
+        const SchemaError::ObjectError& objectError = std::get<SchemaError::ObjectError>(schemaError.information.value());
+        Put(out, StoredObject);
+        Put(out, objectError.key.has_value());
+        Put(out, static_cast<uint32_t>(objectError.key.value_or("").size()));
+        out += objectError.key.value_or("");
+    }
+
+    // The node the expected value was compiled from, + 1 so that 0 means none
+    uint32_t expected = 0;
+
+    if (schemaError.expected.has_value()) {
+        for (uint32_t i = 0; i < compiled.nodes.size(); i++) {
+            if (compiled.nodes[i].source != nullptr && SameSchemaValue(*compiled.nodes[i].source, schemaError.expected.value())) {
+                expected = i + 1;
+                break;
+            }
+        }
+    }
+
+    Put(out, expected);
+    return out;
+}
+
+std::optional<Schema::ValidationResult> Schema::DecodeResult(const CompiledSchema& compiled, std::string_view bytes) {
+    StoredReader reader = { bytes };
+
+    uint8_t format = 0;
+    StoredOutcome outcome = StoredSuccess;
+
+    if (!reader.Get(format) || format != resultFormat || !reader.Get(outcome))
+        return std::nullopt;
+
+    if (outcome == StoredSuccess)
+        return ValidationResult(ValidationResult::ValidationSuccess());
+
+    if (outcome == StoredParserError) {
+        uint32_t error = 0;
+        int64_t line = 0;
+        int64_t column = 0;
+
+        if (!reader.Get(error) || !reader.Get(line) || !reader.Get(column))
+            return std::nullopt;
+
+        return ValidationResult(ValidationResult::ValidationError(ParserError(static_cast<::ErrorType>(error), static_cast<long>(line), static_cast<long>(column))));
+    }
+
+    if (outcome != StoredSchemaError)
+        return std::nullopt;
+
+    uint32_t errorType = 0;
+    StoredLocation location = StoredNowhere;
+
+    if (!reader.Get(errorType) || !reader.Get(location))
+        return std::nullopt;
+
+    std::optional<std::variant<SchemaError::ArrayError, SchemaError::ObjectError>> information;
+
+    if (location == StoredArray) {
+        bool hasIndex = false;
+        int32_t index = 0;
+
+        if (!reader.Get(hasIndex) || !reader.Get(index))
+            return std::nullopt;
+
+        information = SchemaError::ArrayError(nullptr, hasIndex ? std::optional<int>(index) : std::nullopt);
+    }
+    else if (location == StoredObject) {
+        bool hasKey = false;
+        uint32_t size = 0;
+        std::string key;
+
+        if (!reader.Get(hasKey) || !reader.Get(size) || !reader.Get(key, size))
+            return std::nullopt;
+
+        information = SchemaError::ObjectError(nullptr, hasKey ? std::optional<std::string>(std::move(key)) : std::nullopt);
+    }
+    else if (location != StoredNowhere) {
+        return std::nullopt;
+    }
+
+    uint32_t expected = 0;
+
+    if (!reader.Get(expected) || expected > compiled.nodes.size() || (expected != 0 && compiled.nodes[expected - 1].source == nullptr))
+        return std::nullopt;
+
+    std::optional<SchemaValue> expectedValue;
+    if (expected != 0)
+        expectedValue = *compiled.nodes[expected - 1].source;
+
+    return ValidationResult(ValidationResult::ValidationError(SchemaError(information, static_cast<ErrorType>(errorType), expectedValue)));
+}
@@ -0,0 +1,627 @@
+#include "Schema.h"
+#include "ThreadPool.h"
+#include "ValidationCache.h"
+
+#include <algorithm>
+
+#define GetValidationSuccess ValidationResult(ValidationResult::ValidationSuccess())
+
+const Schema::CompiledSchema::Key* Schema::CompiledSchema::FindKey(const Node& node, std::string_view key) const {
+    const uint32_t index = tables[node.table].Find(key);
+    if (index == KeyTable::NotFound || keys[node.first + index].name != key)
+        return nullptr;
+    return &keys[node.first + index];
+}
+
+std::optional<std::string_view> Schema::DiscriminatorText(const YamlValue& value) {
+    if (const auto* string = std::get_if<parser_types::String>(&value))
+        return string->value;
+    if (const auto* number = std::get_if<parser_types::Number>(&value))
+        return number->value;
+    if (const auto* timestamp = std::get_if<parser_types::Timestamp>(&value))
+        return timestamp->value;
+    return std::nullopt;
+}
+
+uint32_t Schema::CompiledSchema::Discriminator::Pick(const YamlValue& value) const {
+    if (values.empty())
+        return byType[value.index()];
+
+    std::optional<std::string_view> text = DiscriminatorText(value);
+    if (!text.has_value())
+        return NoNode;
+
+    auto it = std::lower_bound(values.begin(), values.end(), text.value(), [](const Key& a, std::string_view b) { return a.name < b; });
+    if (it == values.end() || it->name != text.value())
+        return NoNode;
+    return it->node;
+}
+
+uint32_t Schema::CompiledSchema::Discriminate(const Node& node, const parser_types::Object& object) const {
+    const Discriminator& discriminator = discriminators[node.discriminator];
+
+    std::optional<YamlValue> value = object.Get(discriminator.key);
+    if (!value.has_value())
+        return NoNode;
+
+    return discriminator.Pick(value.value());
+}
+
+/**
+ * @brief Gives each Either node of a compiled schema its Discriminator, if it has one.
+ * @param compiled The compiled schema, with every node compiled.
+ * @note Runs once all nodes are compiled, since an alternative may be an object that is still
+ *       being compiled when its Either is, when the schema refers back to it.
+ */
+static void CompileDiscriminators(Schema::CompiledSchema& compiled) {
+    using CompiledSchema = Schema::CompiledSchema;
+    constexpr uint32_t ObjectBit = CompiledSchema::TypeBitOf<parser_types::Object*>();
+
+    for (CompiledSchema::Node& node : compiled.nodes) {
+        if (node.kind != CompiledSchema::EitherNode)
+            continue;
+
+        CompiledSchema::Discriminator discriminator;
+        std::fill(std::begin(discriminator.byType), std::end(discriminator.byType), CompiledSchema::NoNode);
+
+        const Schema::Either& either = std::get<Schema::Either>(*node.source);
+
+        if (!either.discriminator.empty() && !either.mapping.empty()) {
+            discriminator.key = either.discriminator;
+
+            for (const auto& [value, index] : either.mapping) {
+                if (index < node.count)
+                    discriminator.values.push_back({ value, compiled.alternatives[node.first + index] });
+            }
+
+            std::sort(discriminator.values.begin(), discriminator.values.end(), [](const CompiledSchema::Key& a, const CompiledSchema::Key& b) { return a.name < b.name; });
+        }
+        else {
+            // Without a mapping, only a key whose types tell all object alternatives apart can pick one
+            std::vector<uint32_t> objects;
+            bool onlyObjects = true;
+
+            for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                const CompiledSchema::Node& alternative = compiled.nodes[compiled.alternatives[i]];
+
+                if ((alternative.typeMask & ObjectBit) == 0)
+                    continue;
+
+                if (alternative.kind == CompiledSchema::ObjectNode)
+                    objects.push_back(compiled.alternatives[i]);
+                else
+                    onlyObjects = false;
+            }
+
+            if (!onlyObjects || objects.size() < 2)
+                continue;
+
+            const CompiledSchema::Node& first = compiled.nodes[objects.front()];
+
+            for (uint32_t k = first.first; k < first.first + first.count && discriminator.key.empty(); k++) {
+                const std::string& key = compiled.keys[k].name;
+                uint32_t taken = 0;
+                uint32_t byType[std::size(discriminator.byType)];
+                std::fill(std::begin(byType), std::end(byType), CompiledSchema::NoNode);
+
+                bool distinct = true;
+
+                for (uint32_t object : objects) {
+                    const CompiledSchema::Key* schemaKey = compiled.FindKey(compiled.nodes[object], key);
+                    const uint32_t typeMask = schemaKey != nullptr ? compiled.nodes[schemaKey->node].typeMask : 0;
+
+                    if (schemaKey == nullptr || (typeMask & taken) != 0) {
+                        distinct = false;
+                        break;
+                    }
+
+                    taken |= typeMask;
+                    for (size_t bit = 0; bit < std::size(byType); bit++) {
+                        if (typeMask & (1u << bit))
+                            byType[bit] = object;
+                    }
+                }
+
+                if (distinct) {
+                    discriminator.key = key;
+                    std::copy(std::begin(byType), std::end(byType), std::begin(discriminator.byType));
+                }
+            }
+
+            if (discriminator.key.empty())
+                continue;
+        }
+
+        node.discriminator = static_cast<uint32_t>(compiled.discriminators.size());
+        compiled.discriminators.push_back(std::move(discriminator));
+    }
+}
+
+uint32_t Schema::CompileNode(CompiledSchema& compiled, const SchemaValue& value, const SchemaValue* source, std::unordered_map<const void*, uint32_t>& seen) {
+    uint32_t index = static_cast<uint32_t>(compiled.nodes.size());
+
+    if (const Type* type = std::get_if<Type>(&value)) {
+        compiled.nodes.push_back({ CompiledSchema::ScalarNode, TypeMaskOf(*type), 0, 0, source });
+        return index;
+    }
+
+    if (const Either* either = std::get_if<Either>(&value)) {
+        compiled.nodes.push_back({ CompiledSchema::EitherNode, 0, 0, 0, source });
+
+        // Alternatives are compiled first so that this node's alternatives end up contiguous
+        std::vector<uint32_t> members;
+        members.reserve(either->GetValues().size());
+        uint32_t typeMask = 0;
+
+        for (const SchemaValue& alternative : either->GetValues()) {
+            members.push_back(CompileNode(compiled, alternative, &alternative, seen));
+            typeMask |= compiled.nodes[members.back()].typeMask;
+        }
+
+        CompiledSchema::Node& node = compiled.nodes[index];
+        node.typeMask = typeMask;
+        node.first = static_cast<uint32_t>(compiled.alternatives.size());
+        node.count = static_cast<uint32_t>(members.size());
+        compiled.alternatives.insert(compiled.alternatives.end(), members.begin(), members.end());
+        return index;
+    }
+
+    if (const auto* array = std::get_if<std::shared_ptr<ArrayImplementation>>(&value)) {
+        if (auto it = seen.find(array->get()); it != seen.end())
+            return it->second;
+
+        seen.emplace(array->get(), index);
+        compiled.nodes.push_back({ CompiledSchema::ArrayNode, CompiledSchema::TypeBitOf<parser_types::Array*>(), 0, 0, source });
+
+        uint32_t item = CompileNode(compiled, (*array)->type, &(*array)->type, seen);
+        compiled.nodes[index].first = item;
+        return index;
+    }
+
+    const std::shared_ptr<ObjectImplementation>& object = std::get<std::shared_ptr<ObjectImplementation>>(value);
+
+    if (auto it = seen.find(object.get()); it != seen.end())
+        return it->second;
+
+    seen.emplace(object.get(), index);
+    compiled.nodes.push_back({ CompiledSchema::ObjectNode, CompiledSchema::TypeBitOf<parser_types::Object*>(), 0, 0, source });
+
+    std::vector<CompiledSchema::Key> keys;
+    keys.reserve(object->GetValues().size());
+
+    for (const auto& [key, keyValue] : object->GetValues())
+        keys.push_back({ key, CompileNode(compiled, keyValue, &keyValue, seen) });
+
+    std::sort(keys.begin(), keys.end(), [](const CompiledSchema::Key& a, const CompiledSchema::Key& b) { return a.name < b.name; });
+
+    CompiledSchema::Node& node = compiled.nodes[index];
+    node.first = static_cast<uint32_t>(compiled.keys.size());
+    node.count = static_cast<uint32_t>(keys.size());
+    compiled.keys.insert(compiled.keys.end(), std::make_move_iterator(keys.begin()), std::make_move_iterator(keys.end()));
+    return index;
+}
+
+std::shared_ptr<const Schema::CompiledSchema> Schema::Compile(std::variant<std::shared_ptr<ObjectImplementation>, std::shared_ptr<ArrayImplementation>> schema) {
+    std::shared_ptr<CompiledSchema> compiled = std::make_shared<CompiledSchema>();
+    compiled->schema = schema;
+
+    std::unordered_map<const void*, uint32_t> seen;
+
+    // The root is never reported as an expected type, so it needs no source
+    std::visit([&](const auto& root) {
+        compiled->root = CompileNode(*compiled, SchemaValue(root), nullptr, seen);
+    }, schema);
+
+    // Built once every object has its keys, which a node that refers back to itself only has at the end
+    for (CompiledSchema::Node& node : compiled->nodes) {
+        if (node.kind != CompiledSchema::ObjectNode)
+            continue;
+
+        std::vector<std::string_view> names;
+        names.reserve(node.count);
+        for (uint32_t i = 0; i < node.count; i++)
+            names.push_back(compiled->keys[node.first + i].name);
+
+        node.table = static_cast<uint32_t>(compiled->tables.size());
+        compiled->tables.emplace_back(names);
+    }
+
+    CompileDiscriminators(*compiled);
+
+    // Everything validation reads, in the order it is laid out. Node indices are part of it,
+    // since cached results refer to nodes by index.
+    std::string layout;
+    auto append = [&layout](const auto& value) { layout.append(reinterpret_cast<const char*>(&value), sizeof(value)); };
+
+    append(compiled->root);
+
+    for (const CompiledSchema::Node& node : compiled->nodes) {
+        append(node.kind);
+        append(node.typeMask);
+        append(node.first);
+        append(node.count);
+        append(node.discriminator);
+    }
+
+    for (const CompiledSchema::Key& key : compiled->keys) {
+        append(key.name.size());
+        layout += key.name;
+        append(key.node);
+    }
+
+    for (uint32_t alternative : compiled->alternatives)
+        append(alternative);
+
+    for (const CompiledSchema::Discriminator& discriminator : compiled->discriminators) {
+        append(discriminator.key.size());
+        layout += discriminator.key;
+
+        for (const CompiledSchema::Key& value : discriminator.values) {
+            append(value.name.size());
+            layout += value.name;
+            append(value.node);
+        }
+
+        append(discriminator.byType);
+    }
+
+    compiled->fingerprint = ValidationCache::Hash(layout);
+
+    return compiled;
+}
+
+template<typename F>
+Schema::ValidationResult Schema::ValidateChunks(size_t count, const ParallelContext& parallel, F validateEntry) {
+    const size_t chunks = (count + parallel.grainSize - 1) / parallel.grainSize;
+
+    std::atomic<size_t> firstFailed = SIZE_MAX;
+    std::vector<std::optional<ValidationResult>> errors(chunks);
+
+    ThreadPool::TaskGroup group(*parallel.pool);
+
+    for (size_t chunk = 0; chunk < chunks; chunk++) {
+        group.Run([&, chunk] {
+            const ParallelContext context = { parallel.pool, parallel.grainSize, &firstFailed, chunk, &parallel };
+            const size_t last = std::min(count, (chunk + 1) * parallel.grainSize);
+
+            for (size_t i = chunk * parallel.grainSize; i < last; i++) {
+                if (context.IsCancelled())
+                    return;
+
+                ValidationResult result = validateEntry(i, &context);
+
+                if (std::holds_alternative<ValidationResult::ValidationError>(result.result)) {
+                    errors[chunk] = std::move(result);
+
+                    size_t expected = firstFailed.load();
+                    while (chunk < expected && !firstFailed.compare_exchange_weak(expected, chunk)) {}
+                    return;
+                }
+            }
+        });
+    }
+
+    group.Wait();
+
+    // The first failed chunk is never cancelled, so its error is the one serial validation finds first
+    if (firstFailed != SIZE_MAX)
+        return std::move(errors[firstFailed].value());
+
+    return GetValidationSuccess;
+}
+
+template<typename F>
+Schema::ValidationResult Schema::Recall(ValidationMemo* memo, const void* container, uint32_t node, size_t size, F validate) {
+    if (memo == nullptr) {
+        for (size_t i = 0; i < size; i++) {
+            ValidationResult result = validate(i);
+
+            if (std::holds_alternative<ValidationResult::ValidationError>(result.result))
+                return result;
+        }
+
+        return GetValidationSuccess;
+    }
+
+    // References to the elements of an unordered_map survive rehashing, and validating an entry
+    // only adds the results of the containers nested in it
+    std::vector<ValidationMemo::Entry>& entries = memo->results[container];
+    auto entry = std::find_if(entries.begin(), entries.end(), [node](const ValidationMemo::Entry& known) { return known.node == node; });
+
+    if (entry == entries.end()) {
+        // Every entry is validated, so that fixing the first error reveals the next one without another pass
+        ValidationMemo::Entry validated = { node, {}, {} };
+
+        for (size_t i = 0; i < size; i++) {
+            ValidationResult result = validate(i);
+
+            if (std::holds_alternative<ValidationResult::ValidationError>(result.result))
+                validated.failures.emplace(static_cast<uint32_t>(i), std::move(result));
+        }
+
+        entries.push_back(std::move(validated));
+        entry = entries.end() - 1;
+    }
+    else {
+        for (uint32_t i : entry->changed) {
+            ValidationResult result = validate(i);
+
+            if (std::holds_alternative<ValidationResult::ValidationError>(result.result))
+                entry->failures.insert_or_assign(i, std::move(result));
+            else
+                entry->failures.erase(i);
+        }
+
+        entry->changed.clear();
+    }
+
+    if (entry->failures.empty())
+        return GetValidationSuccess;
+
+    return entry->failures.begin()->second;
+}
+
+Schema::ValidationResult Schema::ValidateCompiledValue(const CompiledSchema& compiled, uint32_t nodeIndex, const YamlValue& yamlValue, const ErrorLocation& location, const ParallelContext* parallel, ValidationMemo* memo) {
+    const CompiledSchema::Node& node = compiled.nodes[nodeIndex];
+    const uint32_t typeBit = CompiledSchema::TypeBit(yamlValue);
+
+    if ((node.typeMask & typeBit) == 0)
+        return GetValidationErrorMismatch(location.ToInformation(), *node.source, yamlValue);
+
+    switch (node.kind) {
+    case CompiledSchema::ScalarNode:
+        return GetValidationSuccess;
+
+    case CompiledSchema::ObjectNode:
+        return ValidateCompiledObject(compiled, nodeIndex, *location.root, std::get<parser_types::Object*>(yamlValue), parallel, memo);
+
+    case CompiledSchema::ArrayNode:
+        return ValidateCompiledArray(compiled, nodeIndex, *location.root, std::get<parser_types::Array*>(yamlValue), parallel, memo);
+
+    case CompiledSchema::EitherNode:
+        // An object only has to match the alternative its discriminator picks, if it picks one
+        if (node.discriminator != CompiledSchema::NoNode && typeBit == CompiledSchema::TypeBitOf<parser_types::Object*>()) {
+            const uint32_t picked = compiled.Discriminate(node, *std::get<parser_types::Object*>(yamlValue));
+
+            if (picked != CompiledSchema::NoNode) {
+                ValidationResult result = ValidateCompiledValue(compiled, picked, yamlValue, location, parallel, memo);
+
+                if (std::holds_alternative<ValidationResult::ValidationSuccess>(result.result))
+                    return result;
+                return GetValidationErrorMismatch(location.ToInformation(), *node.source, yamlValue);
+            }
+        }
+
+        for (uint32_t i = node.first; i < node.first + node.count; i++) {
+            uint32_t alternativeIndex = compiled.alternatives[i];
+            const CompiledSchema::Node& alternative = compiled.nodes[alternativeIndex];
+
+            if ((alternative.typeMask & typeBit) == 0)
+                continue;
+
+            ValidationResult result = GetValidationSuccess;
+
+            if (alternative.kind == CompiledSchema::ObjectNode)
+                result = ValidateCompiledObject(compiled, alternativeIndex, *location.root, std::get<parser_types::Object*>(yamlValue), parallel, memo);
+            else if (alternative.kind == CompiledSchema::ArrayNode)
+                result = ValidateCompiledArray(compiled, alternativeIndex, *location.root, std::get<parser_types::Array*>(yamlValue), parallel, memo);
+
+            if (std::holds_alternative<ValidationResult::ValidationSuccess>(result.result))
+                return result;
+        }
+
+        return GetValidationErrorMismatch(location.ToInformation(), *node.source, yamlValue);
+    }
+
+    return GetValidationError(std::nullopt, ErrorType::UnknownError);
+}
+
+Schema::ValidationResult Schema::ValidateCompiledObject(const CompiledSchema& compiled, uint32_t nodeIndex, const parser_types::Yaml& root, parser_types::Object* object, const ParallelContext* parallel, ValidationMemo* memo) {
+    const CompiledSchema::Node& node = compiled.nodes[nodeIndex];
+
+    if (parallel != nullptr && object->Size() > parallel->grainSize) {
+        return ValidateChunks(object->Size(), *parallel, [&](size_t i, const ParallelContext* chunk) {
+            const auto& [key, value] = object->begin()[i];
+
+            const CompiledSchema::Key* schemaKey = compiled.FindKey(node, key);
+            if (schemaKey == nullptr)
+                return GetValidationSuccess;
+
+            return ValidateCompiledValue(compiled, schemaKey->node, value, ErrorLocation(root, object, key), chunk);
+        });
+    }
+
+    return Recall(memo, object, nodeIndex, object->Size(), [&](size_t i) {
+        const auto& [key, value] = object->begin()[i];
+
+        // Keys that are not part of the schema are allowed
+        const CompiledSchema::Key* schemaKey = compiled.FindKey(node, key);
+        if (schemaKey == nullptr)
+            return GetValidationSuccess;
+
+        return ValidateCompiledValue(compiled, schemaKey->node, value, ErrorLocation(root, object, key), parallel, memo);
+    });
+}
+
+Schema::ValidationResult Schema::ValidateCompiledArray(const CompiledSchema& compiled, uint32_t nodeIndex, const parser_types::Yaml& root, parser_types::Array* array, const ParallelContext* parallel, ValidationMemo* memo) {
+    const uint32_t item = compiled.nodes[nodeIndex].first;
+
+    if (parallel != nullptr && array->Size() > parallel->grainSize) {
+        return ValidateChunks(array->Size(), *parallel, [&](size_t i, const ParallelContext* chunk) {
+            return ValidateCompiledValue(compiled, item, (*array)[i], ErrorLocation(root, array, static_cast<int>(i)), chunk);
+        });
+    }
+
+    return Recall(memo, array, nodeIndex, array->Size(), [&](size_t i) {
+        return ValidateCompiledValue(compiled, item, (*array)[i], ErrorLocation(root, array, static_cast<int>(i)), parallel, memo);
+    });
+}
+
+/**
+ * @brief Runs a validation and adds its wall time to the Statistics of its result, when they are collected.
+ * @param validate Callable returning the ValidationResult.
+ * @return What validate returned.
+ */
+template<typename F>
+static Schema::ValidationResult TimeValidation(F validate) {
+    if constexpr (!Statistics::Enabled) {
+        return validate();
+    }
+    else {
+        Statistics statistics;
+        std::optional<Schema::ValidationResult> result;
+        {
+            PhaseTimer timer(statistics.validateNanoseconds);
+            result.emplace(validate());
+        }
+
+        result->AddStatistics(statistics);
+        return std::move(result.value());
+    }
+}
+
+Schema::ValidationResult Schema::Validate(const parser_types::Yaml& yaml, const CompiledSchema& compiled) {
+    return TimeValidation([&] {
+        const CompiledSchema::Node& root = compiled.nodes[compiled.root];
+
+        if (const auto* object = std::get_if<std::shared_ptr<parser_types::Object>>(&yaml)) {
+            if (root.kind != CompiledSchema::ObjectNode)
+                return GetValidationError(std::nullopt, ErrorType::UnexpectedValue);
+
+            return ValidateCompiledObject(compiled, compiled.root, yaml, object->get());
+        }
+
+        if (root.kind != CompiledSchema::ArrayNode)
+            return GetValidationError(std::nullopt, ErrorType::UnexpectedValue);
+
+        return ValidateCompiledArray(compiled, compiled.root, yaml, std::get<std::shared_ptr<parser_types::Array>>(yaml).get());
+    });
+}
+
+Schema::ValidationResult Schema::Validate(const parser_types::Yaml& yaml, const CompiledSchema& compiled, ValidationMemo& memo) {
+    return TimeValidation([&] {
+        const CompiledSchema::Node& root = compiled.nodes[compiled.root];
+
+        if (const auto* object = std::get_if<std::shared_ptr<parser_types::Object>>(&yaml)) {
+            if (root.kind != CompiledSchema::ObjectNode)
+                return GetValidationError(std::nullopt, ErrorType::UnexpectedValue);
+
+            return ValidateCompiledObject(compiled, compiled.root, yaml, object->get(), nullptr, &memo);
+        }
+
+        if (root.kind != CompiledSchema::ArrayNode)
+            return GetValidationError(std::nullopt, ErrorType::UnexpectedValue);
+
+        return ValidateCompiledArray(compiled, compiled.root, yaml, std::get<std::shared_ptr<parser_types::Array>>(yaml).get(), nullptr, &memo);
+    });
+}
+
+Schema::ValidationResult Schema::Validate(const parser_types::Yaml& yaml, const CompiledSchema& compiled, ThreadPool& pool, size_t grainSize) {
+    return TimeValidation([&] {
+        const CompiledSchema::Node& root = compiled.nodes[compiled.root];
+        // Chunks of 0 entries would divide by zero in ValidateChunks
+        const ParallelContext parallel = { &pool, std::max<size_t>(grainSize, 1) };
+
+        if (const auto* object = std::get_if<std::shared_ptr<parser_types::Object>>(&yaml)) {
+            if (root.kind != CompiledSchema::ObjectNode)
+                return GetValidationError(std::nullopt, ErrorType::UnexpectedValue);
+
+            return ValidateCompiledObject(compiled, compiled.root, yaml, object->get(), &parallel);
+        }
+
+        if (root.kind != CompiledSchema::ArrayNode)
+            return GetValidationError(std::nullopt, ErrorType::UnexpectedValue);
+
+        return ValidateCompiledArray(compiled, compiled.root, yaml, std::get<std::shared_ptr<parser_types::Array>>(yaml).get(), &parallel);
+    });
+}
+
+bool Schema::ErrorCollector::Add(ValidationResult&& error) {
+    if (list.errors.size() >= options.maxErrors) {
+        list.truncated = true;
+        return false;
+    }
+
+    list.errors.push_back(std::move(std::get<ValidationResult::ValidationError>(error.result)));
+
+    if (options.sink)
+        options.sink(list.errors.back());
+    return true;
+}
+
+bool Schema::CollectCompiledValue(const CompiledSchema& compiled, uint32_t nodeIndex, const YamlValue& yamlValue, const ErrorLocation& location, ErrorCollector& collector) {
+    const CompiledSchema::Node& node = compiled.nodes[nodeIndex];
+
+    if ((node.typeMask & CompiledSchema::TypeBit(yamlValue)) == 0)
+        return collector.Add(GetValidationErrorMismatch(location.ToInformation(), *node.source, yamlValue));
+
+    switch (node.kind) {
+    case CompiledSchema::ObjectNode:
+        return CollectCompiledObject(compiled, nodeIndex, *location.root, std::get<parser_types::Object*>(yamlValue), collector);
+
+    case CompiledSchema::ArrayNode:
+        return CollectCompiledArray(compiled, nodeIndex, *location.root, std::get<parser_types::Array*>(yamlValue), collector);
+
+    case CompiledSchema::EitherNode: {
+        // Which alternative the value was meant to match is unknown, so only the Either itself is reported
+        ValidationResult result = ValidateCompiledValue(compiled, nodeIndex, yamlValue, location);
+
+        if (std::holds_alternative<ValidationResult::ValidationError>(result.result))
+            return collector.Add(std::move(result));
+        return true;
+    }
+
+    default:
+        return true;
+    }
+}
+
+bool Schema::CollectCompiledObject(const CompiledSchema& compiled, uint32_t nodeIndex, const parser_types::Yaml& root, parser_types::Object* object, ErrorCollector& collector) {
+    const CompiledSchema::Node& node = compiled.nodes[nodeIndex];
+
+    for (const auto& [key, value] : *object) {
+        const CompiledSchema::Key* schemaKey = compiled.FindKey(node, key);
+        if (schemaKey == nullptr)
+            continue;
+
+        if (!CollectCompiledValue(compiled, schemaKey->node, value, ErrorLocation(root, object, key), collector))
+            return false;
+    }
+
+    return true;
+}
+
+bool Schema::CollectCompiledArray(const CompiledSchema& compiled, uint32_t nodeIndex, const parser_types::Yaml& root, parser_types::Array* array, ErrorCollector& collector) {
+    const uint32_t item = compiled.nodes[nodeIndex].first;
+
+    int i = 0;
+    for (const YamlValue& value : *array) {
+        if (!CollectCompiledValue(compiled, item, value, ErrorLocation(root, array, i++), collector))
+            return false;
+    }
+
+    return true;
+}
+
+Schema::ErrorList Schema::ValidateAll(const parser_types::Yaml& yaml, const CompiledSchema& compiled, const CollectOptions& options) {
+    const CompiledSchema::Node& root = compiled.nodes[compiled.root];
+
+    ErrorList list;
+    ErrorCollector collector = { options, list };
+
+    if (const auto* object = std::get_if<std::shared_ptr<parser_types::Object>>(&yaml)) {
+        if (root.kind != CompiledSchema::ObjectNode)
+            collector.Add(GetValidationError(std::nullopt, ErrorType::UnexpectedValue));
+        else
+            CollectCompiledObject(compiled, compiled.root, yaml, object->get(), collector);
+
+        return list;
+    }
+
+    if (root.kind != CompiledSchema::ArrayNode)
+        collector.Add(GetValidationError(std::nullopt, ErrorType::UnexpectedValue));
+    else
+        CollectCompiledArray(compiled, compiled.root, yaml, std::get<std::shared_ptr<parser_types::Array>>(yaml).get(), collector);
+
+    return list;
+}
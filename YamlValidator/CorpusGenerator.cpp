@@ -0,0 +1,376 @@
+#include "CorpusGenerator.h"
+
+#include <algorithm>
+#include <bit>
+
+using Compiled = Schema::CompiledSchema;
+
+static constexpr uint32_t StringBit = Compiled::TypeBitOf<parser_types::String>();
+static constexpr uint32_t NumberBit = Compiled::TypeBitOf<parser_types::Number>();
+static constexpr uint32_t BooleanBit = Compiled::TypeBitOf<parser_types::Boolean>();
+static constexpr uint32_t TimestampBit = Compiled::TypeBitOf<parser_types::Timestamp>();
+static constexpr uint32_t NullBit = Compiled::TypeBitOf<parser_types::Null>();
+static constexpr uint32_t ObjectBit = Compiled::TypeBitOf<parser_types::Object*>();
+static constexpr uint32_t ArrayBit = Compiled::TypeBitOf<parser_types::Array*>();
+
+/// Words that plain and quoted strings are made of. None of them reads as another type.
+static constexpr std::string_view Words[] = {
+    "alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel",
+    "india", "juliett", "kilo", "lima", "mike", "november", "oscar", "papa",
+};
+
+/**
+ * @brief Gets a value of each type that a type mismatch can put in place of a scalar.
+ * @param bit The bit of the type in a typeMask.
+ */
+static std::string_view MismatchOf(uint32_t bit) {
+    switch (bit) {
+    case StringBit:     return "mismatch";
+    case NumberBit:     return "42";
+    case BooleanBit:    return "true";
+    case TimestampBit:  return "2024-01-01";
+    case NullBit:       return "null";
+    case ObjectBit:     return "{}";
+    default:            return "[]";
+    }
+}
+
+uint64_t CorpusGenerator::Random::Next() {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+CorpusGenerator::CorpusGenerator(const Schema& schema, Options options) : compiled(schema.GetCompiled()), options(options) {
+    outerArrays.assign(compiled.nodes.size(), 0);
+
+    std::vector<bool> visiting(compiled.nodes.size(), false);
+    for (uint32_t node = 0; node < compiled.nodes.size(); node++)
+        outerArrays[node] = CountOuterArrays(node, visiting);
+}
+
+size_t CorpusGenerator::CountOuterArrays(uint32_t node, std::vector<bool>& visiting) {
+    const Compiled::Node& compiledNode = compiled.nodes[node];
+
+    if (visiting[node])
+        return 0;
+    visiting[node] = true;
+
+    size_t count = 0;
+
+    switch (compiledNode.kind) {
+    case Compiled::ScalarNode:
+        break;
+
+    case Compiled::ArrayNode:
+        count = 1;
+        break;
+
+    case Compiled::ObjectNode:
+        for (uint32_t i = compiledNode.first; i < compiledNode.first + compiledNode.count; i++)
+            count += CountOuterArrays(compiled.keys[i].node, visiting);
+        break;
+
+    case Compiled::EitherNode:
+        // Only one alternative is written, so count the one that holds the most
+        for (uint32_t i = compiledNode.first; i < compiledNode.first + compiledNode.count; i++)
+            count = std::max(count, CountOuterArrays(compiled.alternatives[i], visiting));
+        break;
+    }
+
+    visiting[node] = false;
+    return count;
+}
+
+uint32_t CorpusGenerator::Resolve(uint32_t node) {
+    while (compiled.nodes[node].kind == Compiled::EitherNode && compiled.nodes[node].count > 0) {
+        const Compiled::Node& either = compiled.nodes[node];
+        const uint32_t alternative = compiled.alternatives[either.first + random.Below(either.count)];
+
+        // The arrays of the alternatives that were not picked no longer need a share
+        pending -= std::min(pending, outerArrays[node] - std::min(outerArrays[node], outerArrays[alternative]));
+        node = alternative;
+    }
+
+    return node;
+}
+
+void CorpusGenerator::WriteScalar(uint32_t typeMask, uint32_t checked) {
+    const uint32_t scalars = typeMask & (StringBit | NumberBit | BooleanBit | TimestampBit | NullBit);
+
+    // Pick one of the admitted types, the n:th set bit
+    uint32_t bit = scalars == 0 ? NullBit : scalars;
+    for (size_t skip = random.Below(std::popcount(bit)); skip > 0; skip--)
+        bit &= bit - 1;
+    bit &= ~(bit - 1);
+
+    const size_t offset = out.size();
+    const std::string_view word = Words[random.Below(std::size(Words))];
+
+    switch (bit) {
+    case StringBit:
+        if (!random.Chance(options.quoteProbability)) {
+            out += word;
+            out += '-';
+            out += std::to_string(random.Below(1000));
+        }
+        else if (random.Chance(0.5)) {
+            out += '\'';
+            out += word;
+            out += random.Chance(0.5) ? "''s " : ", ";
+            out += Words[random.Below(std::size(Words))];
+            out += '\'';
+        }
+        else {
+            out += '"';
+            out += word;
+            out += random.Chance(0.5) ? "\\t" : ": ";
+            out += Words[random.Below(std::size(Words))];
+            out += '"';
+        }
+        break;
+
+    case NumberBit:
+        switch (random.Below(4)) {
+        case 0:     out += std::to_string(random.Below(100000)); break;
+        case 1:     out += '-' + std::to_string(random.Below(1000)); break;
+        case 2:     out += std::to_string(random.Below(1000)) + '.' + std::to_string(random.Below(100)); break;
+        default:    out += std::to_string(1 + random.Below(9)) + ".5e" + std::to_string(random.Below(10)); break;
+        }
+        break;
+
+    case BooleanBit:
+        out += random.Chance(0.5) ? "true" : "false";
+        break;
+
+    case TimestampBit: {
+        const size_t month = 1 + random.Below(12);
+        const size_t day = 1 + random.Below(28);
+
+        out += std::to_string(2000 + random.Below(30));
+        out += month < 10 ? "-0" : "-";
+        out += std::to_string(month);
+        out += day < 10 ? "-0" : "-";
+        out += std::to_string(day);
+        break;
+    }
+
+    default:
+        out += "null";
+        break;
+    }
+
+    // A defect is only a type mismatch if some type is not admitted
+    if (checked != (StringBit | NumberBit | BooleanBit | TimestampBit | NullBit | ObjectBit | ArrayBit))
+        sites.push_back({ offset, out.size() - offset, checked });
+}
+
+void CorpusGenerator::WriteValue(uint32_t node, size_t indent, size_t depth, bool nested, bool afterKey) {
+    const uint32_t checked = compiled.nodes[node].typeMask;
+    node = Resolve(node);
+
+    const Compiled::Node& resolved = compiled.nodes[node];
+
+    if (resolved.kind == Compiled::ScalarNode || resolved.kind == Compiled::EitherNode) {
+        if (afterKey)
+            out += ' ';
+        WriteScalar(resolved.typeMask, checked);
+        return;
+    }
+
+    if (options.style == FlowStyle) {
+        if (afterKey)
+            out += ' ';
+        resolved.kind == Compiled::ObjectNode ? WriteObject(node, indent, depth, nested) : WriteArray(node, indent, depth, nested);
+        return;
+    }
+
+    // A block object or array after a key starts on the next line, indented further
+    const size_t mark = out.size();
+    if (afterKey) {
+        out += '\n';
+        out.append(indent + 2, ' ');
+        indent += 2;
+    }
+
+    const bool written = resolved.kind == Compiled::ObjectNode ? WriteObject(node, indent, depth, nested) : WriteArray(node, indent, depth, nested);
+
+    if (!written) {
+        out.resize(mark);
+        out += afterKey ? " " : "";
+        out += resolved.kind == Compiled::ObjectNode ? "{}" : "[]";
+    }
+}
+
+bool CorpusGenerator::WriteObject(uint32_t node, size_t indent, size_t depth, bool nested) {
+    const Compiled::Node& object = compiled.nodes[node];
+
+    if (options.style == FlowStyle)
+        out += '{';
+
+    size_t entries = 0;
+
+    auto beginEntry = [&](std::string_view key) {
+        if (entries++ > 0) {
+            if (options.style == FlowStyle) {
+                out += ", ";
+            }
+            else {
+                out += '\n';
+                out.append(indent, ' ');
+            }
+        }
+
+        out += key;
+        out += ':';
+    };
+
+    for (uint32_t i = object.first; i < object.first + object.count; i++) {
+        const Compiled::Key& key = compiled.keys[i];
+
+        // Keys that lead to arrays growing to targetBytes are kept, or the document could not reach it
+        const bool growing = options.targetBytes > 0 && !nested && outerArrays[key.node] > 0;
+
+        if (depth >= options.maxDepth || (!random.Chance(options.keyProbability) && !growing)) {
+            pending -= std::min(pending, outerArrays[key.node]);
+            continue;
+        }
+
+        beginEntry(key.name);
+        WriteValue(key.node, indent, depth + 1, nested, true);
+    }
+
+    // Keys the schema does not have are allowed, and their values are not checked
+    for (size_t i = 0; i < options.extraKeys && depth < options.maxDepth; i++) {
+        const std::string key = "extra" + std::to_string(i);
+        if (compiled.FindKey(object, key) != nullptr)
+            continue;
+
+        beginEntry(key);
+        out += ' ';
+
+        const size_t site = sites.size();
+        WriteScalar(StringBit | NumberBit | BooleanBit, StringBit | NumberBit | BooleanBit);
+        sites.resize(site);
+    }
+
+    if (options.style == FlowStyle)
+        out += '}';
+
+    return options.style == FlowStyle || entries > 0;
+}
+
+bool CorpusGenerator::WriteArray(uint32_t node, size_t indent, size_t depth, bool nested) {
+    const uint32_t item = compiled.nodes[node].first;
+
+    // Arrays outside of any other array grow the document to targetBytes, sharing what is left of it
+    const bool outermost = !nested && options.targetBytes > 0;
+    const size_t start = out.size();
+    const size_t share = outermost ? (options.targetBytes - std::min(options.targetBytes, start)) / std::max<size_t>(pending, 1) : 0;
+    const size_t count = depth >= options.maxDepth || outermost ? 0 : random.Below(2 * options.items + 1);
+
+    if (options.style == FlowStyle)
+        out += '[';
+
+    size_t items = 0;
+
+    while (depth < options.maxDepth && (outermost ? out.size() - start < share : items < count)) {
+        if (items++ > 0) {
+            if (options.style == FlowStyle) {
+                out += ", ";
+            }
+            else {
+                out += '\n';
+                out.append(indent, ' ');
+            }
+        }
+
+        if (options.style == FlowStyle) {
+            WriteValue(item, indent, depth + 1, true, false);
+        }
+        else {
+            out += "- ";
+            WriteValue(item, indent + 2, depth + 1, true, false);
+        }
+    }
+
+    if (options.style == FlowStyle)
+        out += ']';
+
+    if (outermost)
+        pending -= std::min<size_t>(pending, 1);
+
+    return options.style == FlowStyle || items > 0;
+}
+
+CorpusGenerator::Sample CorpusGenerator::Next() {
+    random = { options.seed * 0xD1B54A32D192ED03ull + index++ };
+    out.clear();
+    sites.clear();
+    pending = outerArrays[compiled.root];
+
+    const Compiled::Node& root = compiled.nodes[compiled.root];
+    const bool written = root.kind == Compiled::ObjectNode ? WriteObject(compiled.root, 0, 0, false) : WriteArray(compiled.root, 0, 0, false);
+
+    if (!written)
+        out += root.kind == Compiled::ObjectNode ? "{}" : "[]";
+    out += '\n';
+
+    return { std::move(out) };
+}
+
+CorpusGenerator::Sample CorpusGenerator::Next(Defect defect) {
+    Sample sample = Next();
+
+    if (defect != NoDefect)
+        PlaceDefect(sample, defect);
+
+    return sample;
+}
+
+bool CorpusGenerator::PlaceDefect(Sample& sample, Defect defect) {
+    // Most sites give the intended defect, but not all: a mismatch in one alternative of an
+    // Either may still match another, and a quote left open may be closed by a later one
+    const size_t attempts = 16;
+
+    for (size_t attempt = 0; attempt < attempts && !sites.empty(); attempt++) {
+        const Site& site = sites[random.Below(sites.size())];
+        std::string yaml = sample.yaml;
+
+        size_t offset = site.offset;
+
+        if (defect == TypeMismatchDefect) {
+            std::vector<uint32_t> wrong;
+            for (uint32_t bit : { StringBit, NumberBit, BooleanBit, TimestampBit, NullBit, ObjectBit, ArrayBit })
+                if ((site.typeMask & bit) == 0)
+                    wrong.push_back(bit);
+
+            yaml.replace(site.offset, site.size, MismatchOf(wrong[random.Below(wrong.size())]));
+        }
+        else {
+            const size_t lineStart = yaml.rfind('\n', site.offset) == std::string::npos ? 0 : yaml.rfind('\n', site.offset) + 1;
+
+            switch (random.Below(lineStart > 0 ? 3 : 2)) {
+            case 0:     yaml.replace(site.offset, site.size, "\"unterminated"); break;
+            case 1:     yaml.replace(site.offset, site.size, "[unterminated"); break;
+            default:    yaml.insert(lineStart, " "); offset = lineStart; break;
+            }
+        }
+
+        ParserResult parsed = ParseYamlText(yaml);
+
+        const bool placed = defect == SyntaxDefect
+            ? parsed.IsError()
+            : !parsed.IsError() && !std::holds_alternative<Schema::ValidationResult::ValidationSuccess>(Schema::Validate(parsed.GetResult(), compiled).result);
+
+        if (placed) {
+            sample.line = 1 + static_cast<long>(std::count(yaml.begin(), yaml.begin() + offset, '\n'));
+            sample.yaml = std::move(yaml);
+            sample.defect = defect;
+            return true;
+        }
+    }
+
+    return false;
+}
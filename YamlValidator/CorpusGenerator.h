@@ -0,0 +1,178 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Schema.h"
+
+/**
+ * @class CorpusGenerator
+ * @brief Class that generates Yaml documents matching a Schema, to benchmark and test the parser
+ *        and validator with documents of a chosen size, shape and style.
+ * @note Generation is deterministic: the same schema and Options give the same documents, in the
+ *       same order, on every platform. Documents only use what YamlParser reads, so keys are never
+ *       quoted and flow collections never span lines. Keys are written as the schema names them.
+ */
+class CorpusGenerator {
+public:
+    /**
+     * @enum Style
+     * @brief Enum representing how objects and arrays are written.
+     */
+    enum Style {
+        BlockStyle,     /// Indented keys and - items, one value per line.
+        FlowStyle,      /// {key: value} and [item, item], the whole document on one line.
+    };
+
+    /**
+     * @enum Defect
+     * @brief Enum representing what is wrong with a generated document.
+     */
+    enum Defect {
+        NoDefect,           /// The document parses and validates.
+        TypeMismatchDefect, /// The document parses, but one scalar has a type the schema does not admit there.
+        SyntaxDefect,       /// The document does not parse: a quote or [ is left open, or a line is indented too far.
+    };
+
+    /**
+     * @struct Options
+     * @brief Struct representing the size, shape and style of the generated documents.
+     */
+    struct Options {
+        uint64_t seed = 1;              /// Seed of the documents. Each seed gives a different sequence.
+        size_t targetBytes = 0;         /// Size that the outermost arrays grow the document to. 0 gives them `items` items like the others.
+        Style style = BlockStyle;       /// How objects and arrays are written.
+        size_t items = 4;               /// Average number of items of the arrays that do not grow to targetBytes.
+        double keyProbability = 1.0;    /// Probability that each key of the schema is present in an object. Keys holding arrays that grow to targetBytes always are.
+        size_t extraKeys = 0;           /// Keys that are not part of the schema added to each object.
+        double quoteProbability = 0.25; /// Probability that a string is quoted.
+        size_t maxDepth = 64;           /// Objects and arrays nested deeper than this are left empty.
+    };
+
+    /**
+     * @struct Sample
+     * @brief Struct representing one generated document.
+     */
+    struct Sample {
+        std::string yaml;           /// The document.
+        Defect defect = NoDefect;   /// What is wrong with it.
+        long line = 0;              /// Line of the defect, 0 if there is none.
+    };
+
+private:
+    /**
+     * @struct Random
+     * @brief Struct representing a splitmix64 generator. Unlike the std distributions, it gives
+     *        the same numbers with every standard library.
+     */
+    struct Random {
+        uint64_t state;     /// Advanced by every call.
+
+        uint64_t Next();
+
+        /// A number in [0, n), 0 if n is 0.
+        size_t Below(size_t n) { return n == 0 ? 0 : static_cast<size_t>(Next() % n); }
+
+        /// True with the given probability.
+        bool Chance(double probability) { return static_cast<double>(Next() >> 11) * 0x1.0p-53 < probability; }
+    };
+
+    /**
+     * @struct Site
+     * @brief Struct representing a scalar of the document that the schema checks, where a defect can be placed.
+     */
+    struct Site {
+        size_t offset;      /// Offset of the scalar in the document, including any opening quote.
+        size_t size;        /// Length of the scalar, including any quotes.
+        uint32_t typeMask;  /// The types the schema admits there.
+    };
+
+    const Schema::CompiledSchema& compiled;     /// The schema the documents match, which generation walks.
+    Options options;                            /// Size, shape and style of the documents.
+    std::vector<size_t> outerArrays;            /// For each node, how many arrays not nested in another array a value of it holds.
+    uint64_t index = 0;                         /// Number of documents generated so far.
+
+    Random random{ 0 };                         /// Generator of the document being written.
+    std::string out;                            /// The document being written.
+    std::vector<Site> sites;                    /// Its scalars that the schema checks.
+    size_t pending = 0;                         /// Outermost arrays not written yet, which share what is left of targetBytes.
+
+    /**
+     * @brief Counts the arrays not nested in another array that a value of a node holds.
+     * @param node Index of the node.
+     * @param visiting Nodes whose count is being computed, so that recursive schemas terminate.
+     */
+    size_t CountOuterArrays(uint32_t node, std::vector<bool>& visiting);
+
+    /**
+     * @brief Picks an alternative of Either nodes until reaching a node of another kind.
+     * @return Index of that node.
+     */
+    uint32_t Resolve(uint32_t node);
+
+    /**
+     * @brief Writes a scalar of one of the types of a typeMask, and records its Site.
+     * @param typeMask The types to choose from.
+     * @param checked The types the schema admits there, kept in the Site.
+     */
+    void WriteScalar(uint32_t typeMask, uint32_t checked);
+
+    /**
+     * @brief Writes the value after a key or a - item.
+     * @param node Index of the node of the value.
+     * @param indent Column of the key, or of the item after the -.
+     * @param depth Number of objects and arrays around the value.
+     * @param nested True if the value is inside an array.
+     * @param afterKey True if the value follows a key rather than a -.
+     */
+    void WriteValue(uint32_t node, size_t indent, size_t depth, bool nested, bool afterKey);
+
+    /**
+     * @brief Writes the entries of an object. In block style the first key is written at the current
+     *        position and the others at indent; in flow style the braces are written as well.
+     * @return False if nothing was written because the object is empty, in block style.
+     */
+    bool WriteObject(uint32_t node, size_t indent, size_t depth, bool nested);
+
+    /**
+     * @brief Writes the items of an array, like WriteObject.
+     * @return False if nothing was written because the array is empty, in block style.
+     */
+    bool WriteArray(uint32_t node, size_t indent, size_t depth, bool nested);
+
+    /**
+     * @brief Places a defect at a site of the document, and checks that it has the intended effect.
+     * @param sample The valid document. Holds the defect and its line on success.
+     * @param defect TypeMismatchDefect or SyntaxDefect.
+     * @return True if the defect was placed.
+     */
+    bool PlaceDefect(Sample& sample, Defect defect);
+
+public:
+    /**
+     * @brief Constructor for CorpusGenerator.
+     * @param schema The schema the documents match. Must outlive the generator.
+     * @param options Size, shape and style of the documents.
+     */
+    CorpusGenerator(const Schema& schema, Options options);
+
+    /**
+     * @brief Constructor for CorpusGenerator with the default Options.
+     * @param schema The schema the documents match. Must outlive the generator.
+     */
+    explicit CorpusGenerator(const Schema& schema) : CorpusGenerator(schema, Options()) {}
+
+    /**
+     * @brief Generates the next valid document.
+     */
+    Sample Next();
+
+    /**
+     * @brief Generates the next document with a defect.
+     * @param defect The kind of defect. The document gets exactly one.
+     * @return The document. Its defect is NoDefect if the schema leaves no scalar where the
+     *         defect has the intended effect.
+     */
+    Sample Next(Defect defect);
+};
@@ -0,0 +1,142 @@
+#include "DocumentStream.h"
+
+#include <algorithm>
+
+/**
+ * @brief Checks if a line is a document marker: --- or ... alone or followed by a space.
+ * @param line The line, without its newline.
+ * @param marker "---" or "...".
+ */
+static bool IsMarker(std::string_view line, std::string_view marker) {
+    return line.starts_with(marker) && (line.size() == marker.size() || line[3] == ' ' || line[3] == '\t' || line[3] == '\r');
+}
+
+/**
+ * @brief Finds where the content of a line starts.
+ * @param line The line, without its newline.
+ * @return Index of its first character that is not a space, or the size of the line if it is blank or a comment.
+ */
+static size_t ContentOf(std::string_view line) {
+    const size_t first = line.find_first_not_of(" \t\r");
+
+    if (first == std::string_view::npos || line[first] == '#')
+        return line.size();
+
+    return first;
+}
+
+std::optional<DocumentStream> DocumentStream::FromFile(const std::string& filePath) {
+    std::FILE* file = std::fopen(filePath.c_str(), "rb");
+    if (file == nullptr)
+        return std::nullopt;
+
+    DocumentStream stream(file);
+    stream.file = std::shared_ptr<std::FILE>(file, [](std::FILE* owned) { std::fclose(owned); });
+    return stream;
+}
+
+std::string_view DocumentStream::View() const {
+    return file != nullptr ? std::string_view(buffer) : input;
+}
+
+bool DocumentStream::Refill() {
+    // Bytes before the document being scanned are no longer needed
+    const size_t consumed = contentBegin.value_or(position);
+
+    buffer.erase(0, consumed);
+    position -= consumed;
+
+    if (contentBegin.has_value()) {
+        *contentBegin -= consumed;
+        contentEnd -= consumed;
+    }
+
+    // Reads grow with the document, so a large one is not scanned again for every block
+    const size_t used = buffer.size();
+    const size_t size = std::max(BlockSize, used);
+
+    buffer.resize(used + size);
+    const size_t read = std::fread(buffer.data() + used, 1, size, file.get());
+    buffer.resize(used + read);
+
+    if (read == 0) {
+        complete = true;
+        return !std::ferror(file.get());
+    }
+
+    return true;
+}
+
+DocumentStream::Entry DocumentStream::Take() {
+    YamlParser parser(View().substr(*contentBegin, contentEnd - *contentBegin), CopyScalars);
+    parser.SetStartPosition(contentStart);
+
+    Entry entry = { index++, contentStart.line, parser.Parse() };
+    contentBegin.reset();
+    return entry;
+}
+
+std::optional<DocumentStream::Entry> DocumentStream::Next() {
+    while (true) {
+        const std::string_view view = View();
+
+        while (position < view.size()) {
+            size_t newline = view.find('\n', position);
+
+            // The last line only counts once nothing can follow it
+            if (newline == std::string_view::npos && !complete)
+                break;
+
+            const size_t lineEnd = newline == std::string_view::npos ? view.size() : newline;
+            const size_t next = newline == std::string_view::npos ? view.size() : newline + 1;
+            const std::string_view text = view.substr(position, lineEnd - position);
+
+            if (IsMarker(text, "---") || IsMarker(text, "...")) {
+                std::optional<Entry> entry;
+                if (contentBegin.has_value())
+                    entry = Take();
+
+                // The content of the next document may start on the marker line, eg. --- [1, 2]
+                const size_t first = 3 + ContentOf(text.substr(3));
+                if (first < text.size()) {
+                    contentBegin = position + first;
+                    contentEnd = next;
+                    contentStart = { line, static_cast<long>(first + 1) };
+                }
+
+                position = next;
+                line++;
+
+                if (entry.has_value())
+                    return entry;
+
+                continue;
+            }
+
+            // Directives belong to the document after them, and are not part of its content
+            const size_t first = ContentOf(text);
+            if (first < text.size() && text[0] != '%') {
+                if (!contentBegin.has_value()) {
+                    contentBegin = position + first;
+                    contentStart = { line, static_cast<long>(first + 1) };
+                }
+                contentEnd = next;
+            }
+
+            position = next;
+            line++;
+        }
+
+        if (complete) {
+            if (contentBegin.has_value())
+                return Take();
+
+            return std::nullopt;
+        }
+
+        if (!Refill()) {
+            contentBegin.reset();
+            return Entry{ index++, line, ParserResult(ErrorType::InvalidInputError, line, 1) };
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "YamlParser.h"
+
+/**
+ * @class DocumentStream
+ * @brief Class that reads a Yaml stream of many documents, separated by --- and ... lines,
+ *        and parses one document at a time.
+ * @note Files and pipes are read in blocks, and only the bytes of the document being parsed are
+ *       kept, so memory stays bounded by the largest document instead of growing with the stream.
+ *       Each document is parsed with CopyScalars into its own Document, which is released as soon
+ *       as its result is. Blank and comment lines around the content of a document, and directives,
+ *       are not part of it. Documents with no content at all, like the one before a
+ *       leading ---, are skipped. Positions in parser errors are lines and columns of the stream.
+ */
+class DocumentStream {
+public:
+    /**
+     * @struct Entry
+     * @brief Struct representing one document of the stream.
+     */
+    struct Entry {
+        size_t index;           /// Index of the document in the stream, from 0, not counting skipped ones.
+        long line;              /// Line of the stream where the content of the document starts.
+        ParserResult result;    /// The parsed document, or the ParserError.
+    };
+
+    static constexpr size_t BlockSize = 1 << 16; /// Size of each read from a file or pipe.
+
+private:
+    std::shared_ptr<std::FILE> file;    /// The file or pipe being read, nullptr for input already in memory.
+    std::string buffer;                 /// Bytes read from file and not consumed yet.
+    std::string_view input;             /// The input, when it is already in memory.
+    bool complete = false;              /// True once everything up to the end of the stream can be scanned.
+
+    size_t position = 0;                /// Offset in View() of the next line to scan.
+    long line = 1;                      /// Line of the stream at position.
+
+    std::optional<size_t> contentBegin; /// Offset in View() of the first character of the document being scanned, if it has any content yet.
+    size_t contentEnd = 0;              /// Offset in View() one past its last content line.
+    SourcePosition contentStart;        /// Line and column of contentBegin.
+
+    size_t index = 0;                   /// Number of documents returned so far.
+
+    /**
+     * @brief Gets the bytes that can be scanned: the input in memory, or the buffer.
+     */
+    std::string_view View() const;
+
+    /**
+     * @brief Drops the bytes before the document being scanned and reads the next block.
+     * @return False if the read failed.
+     */
+    bool Refill();
+
+    /**
+     * @brief Parses the content of the document that was scanned and starts the next one.
+     * @return The entry of the document.
+     */
+    Entry Take();
+
+public:
+    /**
+     * @brief Constructor for DocumentStream over a stream that is already open, eg. stdin.
+     * @param file The stream to read from. Not closed by the DocumentStream.
+     */
+    explicit DocumentStream(std::FILE* file) : file(file, [](std::FILE*) {}) {}
+
+    /**
+     * @brief Constructor for DocumentStream over Yaml data that is already in memory.
+     * @param input The Yaml data itself, not a file path. Must stay valid while documents are read.
+     */
+    explicit DocumentStream(std::string_view input) : input(input), complete(true) {}
+
+    /**
+     * @brief Opens a file to read documents from.
+     * @param filePath The file path to the input file.
+     * @return An optional containing the DocumentStream, std::nullopt if the file could not be opened.
+     */
+    static std::optional<DocumentStream> FromFile(const std::string& filePath);
+
+    /**
+     * @brief Reads and parses the next document.
+     * @return The entry of the document, std::nullopt after the last one. A failed read gives
+     *         an entry with an InvalidInputError and ends the stream.
+     */
+    std::optional<Entry> Next();
+};
@@ -0,0 +1,616 @@
+#include "IncrementalDocument.h"
+
+#include <algorithm>
+#include <cstring>
+
+/**
+ * @class IncrementalDocument::SpanBuilder
+ * @brief YamlEventHandler that builds values into an existing Document, like the DocumentBuilder
+ *        of YamlParser does with CopyScalars, and records the span of every value.
+ */
+class IncrementalDocument::SpanBuilder : public YamlEventHandler {
+private:
+    /**
+     * @struct Frame
+     * @brief An Object or Array that is still being parsed.
+     */
+    struct Frame {
+        parser_types::Object* object = nullptr; /// The open Object, if any.
+        parser_types::Array* array = nullptr;   /// The open Array, if any.
+        std::string_view key;                   /// The key the next value of object belongs to.
+        SourcePosition keyPosition;             /// Where that key starts, for a DuplicateKeyError.
+        Span* span = nullptr;                   /// The span of the open Object or Array.
+        size_t first = 0;                       /// Index of that span in spans.
+    };
+
+    Document& document;             /// Owns the built values.
+    std::deque<Span>& nodes;        /// Owns the built spans.
+    const YamlParser& parser;       /// The parser, which is where each value ends when its last event arrives.
+    std::string_view text;          /// The parsed text.
+    long line;                      /// The line of lineStart. Positions only move forward, so neither does this.
+    size_t lineStart;               /// Offset of the first character of line.
+    std::vector<Frame> stack;       /// The open containers, innermost last.
+
+    /**
+     * @brief Converts a position of the current parse to an offset in the text.
+     * @param position A position at or after the previous one converted.
+     */
+    size_t OffsetOf(SourcePosition position) {
+        while (line < position.line) {
+            lineStart = text.find('\n', lineStart) + 1;
+            line++;
+        }
+        return lineStart + static_cast<size_t>(position.column - 1);
+    }
+
+    /**
+     * @brief Adds a value to the innermost open container and starts its span.
+     * @param value The value.
+     * @param position Where the value starts.
+     * @return The span, nullptr after failing with DuplicateKeyError.
+     */
+    Span* Add(const YamlValue& value, SourcePosition position) {
+        Span span = { OffsetOf(position), 0, position, position };
+
+        if (stack.empty()) {
+            root = value;
+        }
+        else if (Frame& top = stack.back(); top.object != nullptr) {
+            span.parent = top.span;
+            span.slot = static_cast<uint32_t>(top.object->Size());
+
+            // As in the DocumentBuilder, the lookup of Emplace is what detects duplicates
+            if (!top.object->Emplace(top.key, value)) {
+                Fail(ErrorType::DuplicateKeyError, top.keyPosition);
+                return nullptr;
+            }
+        }
+        else {
+            span.parent = top.span;
+            span.slot = static_cast<uint32_t>(top.array->Size());
+            top.array->PushBack(value);
+        }
+
+        if (parser_types::Object* const* object = std::get_if<parser_types::Object*>(&value))
+            span.object = *object;
+        else if (parser_types::Array* const* array = std::get_if<parser_types::Array*>(&value))
+            span.array = *array;
+
+        spans.push_back(&nodes.emplace_back(span));
+        return spans.back();
+    }
+
+    /**
+     * @brief Ends a span where the parser is now.
+     * @param span The span.
+     * @param first Index of the span in spans.
+     */
+    void Close(Span& span, size_t first) {
+        span.end = parser.Offset();
+        span.stop = parser.Position();
+        span.size = static_cast<uint32_t>(spans.size() - first);
+    }
+
+public:
+    YamlValue root = Null();        /// The value that was parsed.
+    std::vector<Span*> spans;       /// The span of the value and of every value nested in it, in document order.
+
+    /**
+     * @brief Constructor for SpanBuilder.
+     * @param document Owns the built values.
+     * @param nodes Owns the built spans.
+     * @param parser The parser that sends the events.
+     * @param text The text it parses.
+     * @param begin Offset of the first character of the value.
+     * @param start Line and column of that character.
+     */
+    SpanBuilder(Document& document, std::deque<Span>& nodes, const YamlParser& parser, std::string_view text, size_t begin, SourcePosition start)
+        : document(document), nodes(nodes), parser(parser), text(text), line(start.line), lineStart(begin - static_cast<size_t>(start.column - 1)) {}
+
+    bool BeginObject(SourcePosition position) override {
+        parser_types::Object* object = document.NewObject();
+        Span* span = Add(object, position);
+        if (span == nullptr)
+            return false;
+
+        stack.push_back({ object, nullptr, {}, {}, span, spans.size() - 1 });
+        return true;
+    }
+
+    bool Key(std::string_view key, SourcePosition position) override {
+        Frame& top = stack.back();
+        top.key = document.CopyString(key);
+        top.keyPosition = position;
+        return true;
+    }
+
+    bool EndObject(SourcePosition) override {
+        Close(*stack.back().span, stack.back().first);
+        stack.pop_back();
+        return true;
+    }
+
+    bool BeginArray(SourcePosition position) override {
+        parser_types::Array* array = document.NewArray();
+        Span* span = Add(array, position);
+        if (span == nullptr)
+            return false;
+
+        stack.push_back({ nullptr, array, {}, {}, span, spans.size() - 1 });
+        return true;
+    }
+
+    bool EndArray(SourcePosition) override {
+        Close(*stack.back().span, stack.back().first);
+        stack.pop_back();
+        return true;
+    }
+
+    bool Scalar(const YamlValue& value, SourcePosition position) override {
+        // The value views the scalar being read, which does not outlive the event
+        Span* span;
+
+        if (const parser_types::String* string = std::get_if<parser_types::String>(&value))
+            span = Add(parser_types::String(document.CopyString(string->value)), position);
+        else if (const parser_types::Number* number = std::get_if<parser_types::Number>(&value))
+            span = Add(parser_types::Number(document.CopyString(number->value)), position);
+        else if (const parser_types::Timestamp* timestamp = std::get_if<parser_types::Timestamp>(&value))
+            span = Add(parser_types::Timestamp(document.CopyString(timestamp->value)), position);
+        else
+            span = Add(value, position);
+
+        if (span == nullptr)
+            return false;
+
+        Close(*span, spans.size() - 1);
+        return true;
+    }
+};
+
+IncrementalDocument::IncrementalDocument(std::string text) : buffer(std::move(text)), gapBegin(buffer.size()), gapEnd(buffer.size()) {
+    ParseAll();
+}
+
+void IncrementalDocument::MoveGap(size_t offset) {
+    if (offset < gapBegin)
+        std::memmove(buffer.data() + gapEnd - (gapBegin - offset), buffer.data() + offset, gapBegin - offset);
+    else if (offset > gapBegin)
+        std::memmove(buffer.data() + gapBegin, buffer.data() + gapEnd, offset - gapBegin);
+
+    gapEnd = offset + (gapEnd - gapBegin);
+    gapBegin = offset;
+}
+
+IncrementalDocument::Shift IncrementalDocument::Replace(size_t offset, size_t length, std::string_view replacement) {
+    MoveGap(offset);
+
+    const char* removed = buffer.data() + gapEnd;
+    const Shift shift = {
+        static_cast<int64_t>(replacement.size()) - static_cast<int64_t>(length),
+        static_cast<long>(std::count(replacement.begin(), replacement.end(), '\n')) - static_cast<long>(std::count(removed, removed + length, '\n'))
+    };
+
+    gapEnd += length;
+
+    // The gap grows by a quarter of the text at a time, so that typing moves each byte a constant number of times
+    if (gapEnd - gapBegin < replacement.size()) {
+        const size_t grow = replacement.size() + Size() / 4 - (gapEnd - gapBegin);
+        buffer.insert(gapEnd, grow, '\0');
+        gapEnd += grow;
+    }
+
+    replacement.copy(buffer.data() + gapBegin, replacement.size());
+    gapBegin += replacement.size();
+    return shift;
+}
+
+std::string_view IncrementalDocument::View(size_t end) {
+    end = std::min(end, Size());
+    if (gapBegin < end)
+        MoveGap(end);
+
+    return std::string_view(buffer.data(), gapBegin);
+}
+
+void IncrementalDocument::Apply(Span& span, Shift shift) {
+    span.begin = static_cast<size_t>(static_cast<int64_t>(span.begin) + shift.bytes);
+    span.end = static_cast<size_t>(static_cast<int64_t>(span.end) + shift.bytes);
+    span.start.line += shift.lines;
+    span.stop.line += shift.lines;
+}
+
+IncrementalDocument::Shift IncrementalDocument::ShiftOf(const Chunk& chunk) const {
+    Shift shift;
+    for (size_t i = chunk.index + 1; i > 0; i -= i & (~i + 1))
+        shift += shifts[i];
+    return shift;
+}
+
+IncrementalDocument::Span IncrementalDocument::At(const Span& node) const {
+    Span span = node;
+    Apply(span, ShiftOf(*node.chunk));
+    return span;
+}
+
+void IncrementalDocument::Store(Span& node, Span span) {
+    Apply(span, -ShiftOf(*node.chunk));
+    node = span;
+}
+
+IncrementalDocument::Place IncrementalDocument::PlaceOf(const Span& span) const {
+    const std::vector<Span*>& spans = span.chunk->spans;
+    return { span.chunk->index, static_cast<size_t>(std::find(spans.begin(), spans.end(), &span) - spans.begin()) };
+}
+
+void IncrementalDocument::Next(Place& place) const {
+    if (++place.item == chunks[place.chunk]->spans.size()) {
+        place.chunk++;
+        place.item = 0;
+    }
+}
+
+IncrementalDocument::Place IncrementalDocument::FirstFrom(size_t offset) const {
+    // Spans are in document order, so the first chunk whose last span is at or after offset holds it
+    size_t low = 0, high = chunks.size();
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (At(*chunks[middle]->spans.back()).begin < offset)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    if (low == chunks.size())
+        return { chunks.size(), 0 };
+
+    const Chunk& chunk = *chunks[low];
+    const int64_t shift = ShiftOf(chunk).bytes;
+    auto first = std::partition_point(chunk.spans.begin(), chunk.spans.end(), [&](const Span* span) {
+        return static_cast<int64_t>(span->begin) + shift < static_cast<int64_t>(offset);
+    });
+
+    return { low, static_cast<size_t>(first - chunk.spans.begin()) };
+}
+
+void IncrementalDocument::Move(Place place, Shift shift) {
+    if (place.chunk == chunks.size())
+        return;
+
+    // The rest of the chunk moves span by span, the chunks after it through the tree
+    size_t from = place.chunk;
+    if (place.item != 0) {
+        const std::vector<Span*>& spans = chunks[place.chunk]->spans;
+        for (size_t i = place.item; i < spans.size(); i++)
+            Apply(*spans[i], shift);
+        from++;
+    }
+
+    for (size_t i = from + 1; i < shifts.size(); i += i & (~i + 1))
+        shifts[i] += shift;
+}
+
+void IncrementalDocument::Splice(Place place, size_t replaced, const std::vector<Span*>& added) {
+    Chunk& chunk = *chunks[place.chunk];
+
+    // The replaced spans may run on into the chunks after this one
+    size_t last = place.chunk;
+    for (size_t remaining = replaced, item = place.item; remaining > 0; last++, item = 0) {
+        std::vector<Span*>& spans = chunks[last]->spans;
+        const size_t count = std::min(remaining, spans.size() - item);
+
+        spans.erase(spans.begin() + item, spans.begin() + item + count);
+        remaining -= count;
+    }
+
+    for (Span* span : added) {
+        span->chunk = &chunk;
+        Store(*span, *span);
+    }
+
+    chunk.spans.insert(chunk.spans.begin() + place.item, added.begin(), added.end());
+    Rebalance(place.chunk, last - 1);
+}
+
+void IncrementalDocument::Rebalance(size_t first, size_t last) {
+    // The first chunk holds the root, so it is never empty and has no chunk to merge into
+    auto unbalanced = [](const Chunk& chunk) {
+        return chunk.spans.size() > 2 * ChunkSize || (chunk.index != 0 && chunk.spans.size() < ChunkSize / 4);
+    };
+
+    if (std::none_of(chunks.begin() + first, chunks.begin() + last + 1, [&](const auto& chunk) { return unbalanced(*chunk); }))
+        return;
+
+    // Turns the tree back into the Shift added at each chunk, which applies to every chunk from there on
+    std::vector<Shift> added = shifts;
+    for (size_t i = added.size() - 1; i > 0; i--) {
+        if (size_t j = i + (i & (~i + 1)); j < added.size())
+            added[j] -= added[i];
+    }
+
+    std::vector<std::unique_ptr<Chunk>> balanced;
+    std::vector<Shift> balancedAdded = { Shift() };
+
+    // A large chunk is cut into chunks of about ChunkSize. The pieces after the first add no Shift.
+    auto push = [&](std::unique_ptr<Chunk> chunk, Shift shift) {
+        const size_t size = chunk->spans.size();
+        const size_t pieces = std::max<size_t>(1, size / ChunkSize);
+
+        if (pieces == 1 || size <= 2 * ChunkSize) {
+            balanced.push_back(std::move(chunk));
+            balancedAdded.push_back(shift);
+            return;
+        }
+
+        std::vector<Span*> spans = std::move(chunk->spans);
+        for (size_t piece = 0; piece < pieces; piece++) {
+            std::unique_ptr<Chunk> cut = piece == 0 ? std::move(chunk) : std::make_unique<Chunk>();
+            cut->spans.assign(spans.begin() + size * piece / pieces, spans.begin() + size * (piece + 1) / pieces);
+
+            for (Span* span : cut->spans)
+                span->chunk = cut.get();
+
+            balanced.push_back(std::move(cut));
+            balancedAdded.push_back(piece == 0 ? shift : Shift());
+        }
+    };
+
+    for (size_t i = 0; i < chunks.size(); i++) {
+        const Shift shift = added[i + 1];
+
+        if (i < first || i > last || i == 0 || chunks[i]->spans.size() >= ChunkSize / 4) {
+            push(std::move(chunks[i]), shift);
+            continue;
+        }
+
+        // A small chunk joins the previous one, and its spans take on its Shift themselves,
+        // which then starts at the next chunk instead
+        Chunk& previous = *balanced.back();
+        for (Span* span : chunks[i]->spans) {
+            Apply(*span, shift);
+            span->chunk = &previous;
+            previous.spans.push_back(span);
+        }
+
+        if (i + 1 < chunks.size())
+            added[i + 2] += shift;
+
+        if (previous.spans.size() > 2 * ChunkSize) {
+            std::unique_ptr<Chunk> joined = std::move(balanced.back());
+            const Shift joinedShift = balancedAdded.back();
+
+            balanced.pop_back();
+            balancedAdded.pop_back();
+            push(std::move(joined), joinedShift);
+        }
+    }
+
+    chunks = std::move(balanced);
+    for (size_t i = 0; i < chunks.size(); i++)
+        chunks[i]->index = i;
+
+    // Builds the tree over the new chunks in one pass
+    shifts = std::move(balancedAdded);
+    for (size_t i = 1; i < shifts.size(); i++) {
+        if (size_t j = i + (i & (~i + 1)); j < shifts.size())
+            shifts[j] += shifts[i];
+    }
+}
+
+void IncrementalDocument::ParseAll() {
+    document = Document::Create();
+    root.reset();
+    chunks.clear();
+    shifts.assign(1, {});
+    nodes.clear();
+    broken = nullptr;
+    garbageBytes = 0;
+    memo.Clear();
+
+    const std::string_view text = View(Size());
+
+    YamlParser parser(text, CopyScalars);
+    SpanBuilder builder(*document, nodes, parser, text, 0, { 1, 1 });
+    error = parser.ParseValueAt(0, { 1, 1 }, builder);
+
+    statistics.fullParses++;
+    statistics.parsedBytes += parser.Offset();
+
+    if (error.has_value())
+        return;
+
+    if (parser_types::Object** object = std::get_if<parser_types::Object*>(&builder.root))
+        root = document->Share(*object);
+    else if (parser_types::Array** array = std::get_if<parser_types::Array*>(&builder.root))
+        root = document->Share(*array);
+    else {
+        error = ParserError(ErrorType::InvalidDocumentStartError, 1, 1);
+        return;
+    }
+
+    for (size_t i = 0; i < builder.spans.size(); i += ChunkSize) {
+        std::unique_ptr<Chunk> chunk = std::make_unique<Chunk>();
+        chunk->index = chunks.size();
+        chunk->spans.assign(builder.spans.begin() + i, builder.spans.begin() + std::min(i + ChunkSize, builder.spans.size()));
+
+        for (Span* span : chunk->spans)
+            span->chunk = chunk.get();
+        chunks.push_back(std::move(chunk));
+    }
+
+    shifts.assign(chunks.size() + 1, {});
+}
+
+bool IncrementalDocument::ParseSpan(const std::vector<Span*>& path) {
+    Span& node = *path.back();
+    const Span span = At(node);
+
+    std::string_view text;
+    std::optional<YamlParser> parser;
+    std::optional<SpanBuilder> builder;
+    std::optional<ParserError> parseError;
+
+    // The parser looks at most one character past where it stops, so a parse that stops before the
+    // end of the view read the same bytes as it would have in the whole text
+    for (size_t end = span.end + Lookahead; ; end = Size()) {
+        text = View(end);
+        parser.emplace(text, CopyScalars);
+        builder.emplace(*document, nodes, *parser, text, span.begin, span.start);
+        parseError = parser->ParseValueAt(span.begin, span.start, *builder);
+
+        statistics.partialParses++;
+        statistics.parsedBytes += parser->Offset() - span.begin;
+        garbageBytes += parser->Offset() - span.begin;
+
+        if (text.size() == Size() || parser->Offset() + 1 < text.size())
+            break;
+
+        // Ran past the old end by more than the lookahead, so it cannot end where it did before.
+        // A failure there may only be the end of the view, which the whole text has to confirm.
+        if (!parseError.has_value())
+            return false;
+    }
+
+    // Parsing the whole text reaches the value the same way, so it would fail the same way
+    if (parseError.has_value()) {
+        error = parseError;
+        broken = &node;
+        return true;
+    }
+
+    // The value around it only reads the rest of the text as before if it continues at the same
+    // character in the same column. At the end of the text the column no longer matters.
+    if (parser->Offset() != span.end || (span.end != Size() && parser->Position().column != span.stop.column))
+        return false;
+
+    error.reset();
+    broken = nullptr;
+
+    // The containers around the value changed, and the replaced ones are gone
+    for (size_t i = 0; i + 1 < path.size(); i++) {
+        const Span& around = *path[i];
+        memo.Changed(around.object != nullptr ? static_cast<const void*>(around.object) : around.array, path[i + 1]->slot);
+    }
+
+    const Place place = PlaceOf(node);
+    Place replaced = place;
+
+    for (uint32_t i = 0; i < span.size; i++, Next(replaced)) {
+        const Span& old = *chunks[replaced.chunk]->spans[replaced.item];
+        memo.Forget(old.object != nullptr ? static_cast<const void*>(old.object) : old.array);
+    }
+
+    const Span& parent = *span.parent;
+    if (parent.object != nullptr)
+        parent.object->Replace(span.slot, builder->root);
+    else
+        parent.array->Replace(span.slot, builder->root);
+
+    Span& front = *builder->spans.front();
+    front.parent = span.parent;
+    front.slot = span.slot;
+
+    for (size_t i = 0; i + 1 < path.size(); i++) {
+        Span around = At(*path[i]);
+        around.size = around.size - span.size + static_cast<uint32_t>(builder->spans.size());
+
+        if (around.end == span.end)
+            around.stop = front.stop;
+
+        Store(*path[i], around);
+    }
+
+    Splice(place, span.size, builder->spans);
+    return true;
+}
+
+void IncrementalDocument::Edit(size_t offset, size_t length, std::string_view replacement) {
+    statistics.edits++;
+
+    offset = std::min(offset, Size());
+    length = std::min(length, Size() - offset);
+
+    const size_t editEnd = offset + length;
+    const Shift shift = Replace(offset, length, replacement);
+
+    // Replaced values would take up more memory than the Document itself
+    if (chunks.empty() || garbageBytes > Size()) {
+        ParseAll();
+        return;
+    }
+
+    // Spans are in document order, so each group of them is a range of places
+    const Place inside = FirstFrom(offset);
+    const Place after = FirstFrom(editEnd);
+
+    // A value must start before the edit, since its first character decides how it is parsed.
+    // The last one that does is in every value around the edit, which ends where the parse
+    // continues after the edit. After a failed parse, only the value that failed or one around it
+    // can be parsed again.
+    Span* const rootSpan = chunks.front()->spans.front();
+    Span* innermost = rootSpan;
+
+    if (inside.item != 0)
+        innermost = chunks[inside.chunk]->spans[inside.item - 1];
+    else if (inside.chunk != 0)
+        innermost = chunks[inside.chunk - 1]->spans.back();
+
+    auto contains = [](const Span* outer, const Span* inner) {
+        for (; inner != nullptr; inner = inner->parent) {
+            if (inner == outer)
+                return true;
+        }
+        return false;
+    };
+
+    std::vector<Span*> path;
+
+    for (Span* i = innermost; i != nullptr; i = i->parent) {
+        Span span = At(*i);
+
+        if (span.end >= editEnd) {
+            span.end = static_cast<size_t>(static_cast<int64_t>(span.end) + shift.bytes);
+            span.stop.line += shift.lines;
+            Store(*i, span);
+
+            if (!path.empty() || broken == nullptr || contains(i, broken))
+                path.push_back(i);
+        }
+    }
+
+    if (path.empty() || path.back() != rootSpan)
+        path.push_back(rootSpan);
+
+    std::reverse(path.begin(), path.end());
+
+    // The values that started in the replaced part are nested in the innermost one, and start
+    // where the edit does until they are parsed again
+    for (Place place = inside; place != after; Next(place)) {
+        Span& node = *chunks[place.chunk]->spans[place.item];
+        Span span = At(node);
+        span.begin = offset;
+        Store(node, span);
+    }
+
+    // Everything after the edit moved by the same number of bytes and lines
+    Move(after, shift);
+
+    for (; path.size() > 1; path.pop_back()) {
+        if (ParseSpan(path))
+            return;
+    }
+
+    ParseAll();
+}
+
+std::string IncrementalDocument::GetText() const {
+    std::string text(buffer, 0, gapBegin);
+    text.append(buffer, gapEnd);
+    return text;
+}
+
+ParserResult IncrementalDocument::GetResult() const {
+    if (error.has_value())
+        return ParserResult(error->error, error->line, error->column);
+
+    return ParserResult(root.value());
+}
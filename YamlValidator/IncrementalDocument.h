@@ -0,0 +1,259 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Schema.h"
+
+/**
+ * @class IncrementalDocument
+ * @brief Yaml text that is being edited, eg. by an editor or a language server, together with
+ *        the Document parsed from it. An edit only parses the innermost value around it again
+ *        and splices the result into the Document, and Schema::Validate(IncrementalDocument&)
+ *        only revisits the objects and arrays that changed.
+ * @note The parser reads a value the same way wherever it starts, so parsing a value again
+ *       from its first character gives what parsing the whole text would, provided it ends
+ *       where it ended before. When it does not, the value around it is parsed again instead,
+ *       up to the whole text. Edits to the keys of the outermost object always parse the whole text.
+ *       Keys and scalars are copied into the Document, since the text changes under it. Replaced
+ *       values stay in the Document until as many bytes have been parsed again as the text holds,
+ *       then the whole text is parsed into a new Document.
+ *       The text is kept in a gap buffer and the spans of the values in chunks, so an edit only
+ *       moves the bytes between it and the previous edit, the bytes of the reparsed value, and the
+ *       spans of the chunk it is in. Its cost does not grow with the size of the text, apart from
+ *       the log of the number of chunks, and from splitting or merging chunks, which takes time
+ *       in the number of chunks and happens at most once per ChunkSize / 2 values added or removed.
+ */
+class IncrementalDocument {
+public:
+    /**
+     * @struct Statistics
+     * @brief Struct representing how much parsing the edits so far took.
+     */
+    struct Statistics {
+        uint64_t edits = 0;             /// Edits applied.
+        uint64_t partialParses = 0;     /// Values parsed again on their own, including attempts that had to be widened.
+        uint64_t fullParses = 0;        /// Times the whole text was parsed, including the first time.
+        uint64_t parsedBytes = 0;       /// Bytes read by all of them.
+    };
+
+private:
+    friend class Schema;
+
+    struct Chunk;
+
+    /**
+     * @struct Span
+     * @brief Struct representing where a value of the Document was parsed from.
+     */
+    struct Span {
+        size_t begin;                           /// Offset of the first character of the value.
+        size_t end;                             /// Offset where the parse continued after the value.
+        SourcePosition start;                   /// Line and column of begin.
+        SourcePosition stop;                    /// Line and column of end.
+        parser_types::Object* object = nullptr; /// The value, if it is an Object.
+        parser_types::Array* array = nullptr;   /// The value, if it is an Array.
+        Span* parent = nullptr;                 /// The span of the enclosing Object or Array, nullptr for the root.
+        Chunk* chunk = nullptr;                 /// The chunk the span is in.
+        uint32_t size = 1;                      /// Number of spans in this one, itself included. They follow it in document order.
+        uint32_t slot = 0;                      /// Index of the value among the entries of the enclosing Object or Array.
+    };
+
+    /**
+     * @struct Shift
+     * @brief Struct representing how far spans moved since their offsets were stored.
+     */
+    struct Shift {
+        int64_t bytes = 0;                      /// Bytes added before them, negative if removed.
+        long lines = 0;                         /// Lines added before them, negative if removed.
+
+        Shift& operator+=(const Shift& other) { bytes += other.bytes; lines += other.lines; return *this; }
+        Shift& operator-=(const Shift& other) { bytes -= other.bytes; lines -= other.lines; return *this; }
+        Shift operator-() const { return { -bytes, -lines }; }
+    };
+
+    /**
+     * @struct Chunk
+     * @brief A run of consecutive spans, so that adding or removing spans only moves the others in the same chunk.
+     */
+    struct Chunk {
+        std::vector<Span*> spans;               /// The spans, in document order. Never empty.
+        size_t index = 0;                       /// Index of the chunk in chunks, and of its Shift in shifts.
+    };
+
+    /**
+     * @struct Place
+     * @brief Struct representing where a span is among the chunks.
+     */
+    struct Place {
+        size_t chunk = 0;                       /// Index of the chunk, chunks.size() past the last span.
+        size_t item = 0;                        /// Index of the span in the chunk.
+
+        bool operator==(const Place&) const = default;
+    };
+
+    class SpanBuilder;
+
+    static constexpr size_t ChunkSize = 256;    /// Spans per chunk after a split. Chunks are split above twice as many and merged below a quarter.
+    static constexpr size_t Lookahead = 64;     /// Bytes after the old end of a value that are made contiguous with it before it is parsed again.
+
+    std::string buffer;                         /// The text, with a gap at the last edit.
+    size_t gapBegin = 0;                        /// Offset of the gap in buffer, which is also its offset in the text.
+    size_t gapEnd = 0;                          /// Offset in buffer one past the gap.
+
+    std::shared_ptr<Document> document;         /// Owns the parsed values, including replaced ones.
+    std::optional<parser_types::Yaml> root;     /// The root of the Document, if the text parses.
+    std::optional<ParserError> error;           /// Why the text does not parse, if it does not.
+
+    std::deque<Span> nodes;                     /// Owns the spans, including replaced ones, which are released with the Document.
+    std::vector<std::unique_ptr<Chunk>> chunks; /// Every span of the last text that parsed, in document order. See At for their offsets in the current text.
+    std::vector<Shift> shifts;                  /// Fenwick tree of the Shift of each chunk, so that moving every chunk after an edit takes log(n).
+    Span* broken = nullptr;                     /// The span that failed to parse after the last edit. The spans nested in it are stale.
+    size_t garbageBytes = 0;                    /// Bytes parsed again since the Document was created.
+
+    Schema::ValidationMemo memo;                /// Results of validating the objects and arrays of the Document.
+    Statistics statistics;                      /// See Statistics.
+
+    /**
+     * @brief Gets the length of the text.
+     */
+    size_t Size() const { return buffer.size() - (gapEnd - gapBegin); }
+
+    /**
+     * @brief Moves the gap of the buffer.
+     * @param offset Offset in the text where the gap starts afterwards.
+     */
+    void MoveGap(size_t offset);
+
+    /**
+     * @brief Replaces part of the text, leaving the gap after the replacement.
+     * @param offset Offset of the first replaced character.
+     * @param length Number of replaced bytes.
+     * @param replacement The new bytes.
+     * @return How far the text after the replaced part moved.
+     */
+    Shift Replace(size_t offset, size_t length, std::string_view replacement);
+
+    /**
+     * @brief Makes the beginning of the text contiguous, for the parser.
+     * @param end Offset up to which the text must be contiguous, clamped to its size.
+     * @return The text up to the gap, which is at or after end.
+     */
+    std::string_view View(size_t end);
+
+    /**
+     * @brief Gets how far the spans of a chunk moved since their offsets were stored.
+     * @param chunk The chunk.
+     */
+    Shift ShiftOf(const Chunk& chunk) const;
+
+    /**
+     * @brief Moves the offsets of a span.
+     * @param span The span.
+     * @param shift How far it moved.
+     */
+    static void Apply(Span& span, Shift shift);
+
+    /**
+     * @brief Gets a span with offsets in the current text.
+     * @param span The span.
+     */
+    Span At(const Span& span) const;
+
+    /**
+     * @brief Replaces the offsets of a span.
+     * @param node The span.
+     * @param span The span, with offsets in the current text.
+     */
+    void Store(Span& node, Span span);
+
+    /**
+     * @brief Finds a span among the chunks.
+     * @param span The span.
+     */
+    Place PlaceOf(const Span& span) const;
+
+    /**
+     * @brief Gets the span after a place.
+     * @param place A place of a span. Becomes the place after it.
+     */
+    void Next(Place& place) const;
+
+    /**
+     * @brief Finds the first span that starts at or after an offset.
+     * @param offset Offset in the current text.
+     * @return The place of that span, past the last span if there is none.
+     */
+    Place FirstFrom(size_t offset) const;
+
+    /**
+     * @brief Moves the spans from a place on.
+     * @param place The place of the first span that moved.
+     * @param shift How far they moved.
+     */
+    void Move(Place place, Shift shift);
+
+    /**
+     * @brief Replaces consecutive spans.
+     * @param place The place of the first replaced span.
+     * @param replaced Number of replaced spans, at least one.
+     * @param added The spans that take their place, with offsets in the current text.
+     */
+    void Splice(Place place, size_t replaced, const std::vector<Span*>& added);
+
+    /**
+     * @brief Splits chunks that grew too large, and merges ones that shrank too small into the previous chunk.
+     * @param first Index of the first chunk that changed.
+     * @param last Index of the last chunk that changed.
+     */
+    void Rebalance(size_t first, size_t last);
+
+    /**
+     * @brief Parses the whole text into a new Document.
+     */
+    void ParseAll();
+
+    /**
+     * @brief Parses the value of a span again and splices it into the Document.
+     * @param path The spans around the value, outermost first, the span itself last. Not the root.
+     * @return False if the value ended somewhere else than before, so the value around it has to be parsed instead.
+     */
+    bool ParseSpan(const std::vector<Span*>& path);
+
+public:
+    /**
+     * @brief Constructor for IncrementalDocument. Parses the text.
+     * @param text The Yaml data itself, not a file path.
+     */
+    explicit IncrementalDocument(std::string text);
+
+    /**
+     * @brief Replaces part of the text and updates the Document.
+     * @param offset Byte offset of the first replaced character.
+     * @param length Number of replaced bytes, 0 to insert.
+     * @param replacement The new bytes, empty to delete.
+     */
+    void Edit(size_t offset, size_t length, std::string_view replacement);
+
+    /**
+     * @brief Gets the current text.
+     * @note Copies it out of the gap buffer, so it takes time in its size.
+     */
+    std::string GetText() const;
+
+    /**
+     * @brief Gets the result of parsing the current text.
+     * @return The same result ParseYamlText would give for the text. The root shares the Document,
+     *         which later edits keep changing until the text is parsed into a new one.
+     */
+    ParserResult GetResult() const;
+
+    /**
+     * @brief Gets how much parsing the edits so far took.
+     */
+    Statistics GetStatistics() const { return statistics; }
+};
@@ -0,0 +1,159 @@
+#include "InputSource.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool InputSource::TryMap(const std::string& filePath, InputSource& source) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (GetFileType(file) != FILE_TYPE_DISK || !GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file); // The mapping keeps its own reference to the file
+
+    if (mappingHandle == nullptr)
+        return false;
+
+    void* view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mappingHandle);
+        return false;
+    }
+
+    source.mappingHandle = mappingHandle;
+    source.mapping = view;
+    source.size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping stays valid after the descriptor is closed, but still follows the file
+
+    if (view == MAP_FAILED)
+        return false;
+
+    // The parser reads the input front to back exactly once
+    madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+
+    source.mapping = view;
+    source.size = static_cast<size_t>(info.st_size);
+#endif
+
+    source.data = static_cast<const char*>(source.mapping);
+    source.mode = MemoryMapped;
+    return true;
+}
+
+std::optional<InputSource> InputSource::FromFile(const std::string& filePath) {
+    InputSource source;
+
+    if (TryMap(filePath, source))
+        return source;
+
+    // Not a mappable regular file, fall back to block reads
+    std::FILE* file = std::fopen(filePath.c_str(), "rb");
+    if (file == nullptr)
+        return std::nullopt;
+
+    std::optional<InputSource> result = FromStream(file);
+    std::fclose(file);
+    return result;
+}
+
+std::optional<InputSource> InputSource::FromStream(std::FILE* file) {
+    InputSource source;
+    size_t used = 0;
+
+    while (true) {
+        if (source.buffer.size() - used < BlockSize)
+            source.buffer.resize(source.buffer.size() + std::max(BlockSize, source.buffer.size()));
+
+        size_t read = std::fread(source.buffer.data() + used, 1, source.buffer.size() - used, file);
+        used += read;
+
+        if (read == 0) {
+            if (std::ferror(file))
+                return std::nullopt;
+            break;
+        }
+    }
+
+    source.buffer.resize(used);
+    source.buffer.shrink_to_fit();
+
+    source.data = source.buffer.data();
+    source.size = used;
+    source.mode = Buffered;
+    return source;
+}
+
+InputSource::InputSource(InputSource&& other) noexcept {
+    *this = std::move(other);
+}
+
+InputSource& InputSource::operator=(InputSource&& other) noexcept {
+    if (this == &other)
+        return *this;
+
+    Release();
+
+    mode = other.mode;
+    size = other.size;
+    mapping = other.mapping;
+#ifdef _WIN32
+    mappingHandle = other.mappingHandle;
+    other.mappingHandle = nullptr;
+#endif
+    buffer = std::move(other.buffer);
+
+    // A moved vector keeps its heap storage, so only mapped data needs the old pointer
+    data = mode == MemoryMapped ? other.data : buffer.data();
+
+    other.mapping = nullptr;
+    other.data = nullptr;
+    other.size = 0;
+    other.mode = Buffered;
+    return *this;
+}
+
+void InputSource::Release() {
+    if (mapping != nullptr) {
+#ifdef _WIN32
+        UnmapViewOfFile(mapping);
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+#else
+        munmap(mapping, size);
+#endif
+        mapping = nullptr;
+    }
+
+    buffer.clear();
+    data = nullptr;
+    size = 0;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <cstdio>
+
+/**
+ * @class InputSource
+ * @brief Class that owns the bytes of a Yaml input and exposes them as one contiguous range.
+ * @note Regular files are memory-mapped. Anything that cannot be mapped (pipes, character
+ *       devices, empty files) is read in large blocks into an owned buffer instead.
+ * @warning A mapping is not a snapshot. If the file is truncated or rewritten in place while it
+ *          is mapped, the bytes change under the view, and reading past a truncation raises SIGBUS.
+ */
+class InputSource {
+public:
+    /**
+     * @enum Mode
+     * @brief Enum representing how the bytes of an InputSource are backed.
+     */
+    enum Mode {
+        MemoryMapped,   /// The bytes are a read-only mapping of the file.
+        Buffered,       /// The bytes were read into an owned buffer.
+    };
+
+    static constexpr size_t BlockSize = 1 << 16; /// Size of each read when the input cannot be mapped.
+
+private:
+    const char* data = nullptr;     /// Pointer to the first byte of the input.
+    size_t size = 0;                /// Number of bytes in the input.
+    Mode mode = Buffered;           /// How the bytes are backed.
+
+    void* mapping = nullptr;        /// Base address of the mapping when mode == MemoryMapped.
+#ifdef _WIN32
+    void* mappingHandle = nullptr;  /// Handle of the file mapping object.
+#endif
+
+    std::vector<char> buffer;       /// Owned bytes when mode == Buffered.
+
+    InputSource() {}
+
+    /**
+     * @brief Tries to memory-map a regular file.
+     * @param filePath The file path to the input file.
+     * @param source The InputSource to fill in.
+     * @return True if the file was mapped, false if it must be read instead.
+     */
+    static bool TryMap(const std::string& filePath, InputSource& source);
+
+    /**
+     * @brief Releases the mapping or buffer owned by this InputSource.
+     */
+    void Release();
+
+public:
+    /**
+     * @brief Opens a file and exposes its contents as a contiguous byte range.
+     * @param filePath The file path to the input file.
+     * @return An optional containing the InputSource, std::nullopt if the file could not be opened.
+     */
+    static std::optional<InputSource> FromFile(const std::string& filePath);
+
+    /**
+     * @brief Reads an already opened stream until end of file using large block reads.
+     * @param file The stream to read from, eg. stdin or a pipe.
+     * @return An optional containing the InputSource, std::nullopt if a read error occured.
+     */
+    static std::optional<InputSource> FromStream(std::FILE* file);
+
+    InputSource(const InputSource&) = delete;
+    InputSource& operator=(const InputSource&) = delete;
+
+    InputSource(InputSource&& other) noexcept;
+    InputSource& operator=(InputSource&& other) noexcept;
+
+    ~InputSource() { Release(); }
+
+    /**
+     * @brief Get the input as a contiguous byte range.
+     * @return A string_view over the bytes, valid for the lifetime of this InputSource.
+     */
+    std::string_view View() const { return std::string_view(data, size); }
+
+    /**
+     * @brief Get how the bytes of this InputSource are backed.
+     * @return The Mode of this InputSource.
+     */
+    Mode GetMode() const { return mode; }
+};
@@ -0,0 +1,76 @@
+#include "KeyTable.h"
+
+#include <algorithm>
+#include <bit>
+
+/// Seeds tried for a bucket before the table is built again with more slots.
+static constexpr uint32_t MaxSeed = 1 << 16;
+
+bool KeyTable::Build(std::span<const std::string_view> keys) {
+    std::vector<uint64_t> hashes(keys.size());
+    std::vector<std::vector<uint32_t>> buckets(bucketMask + 1);
+
+    for (uint32_t i = 0; i < keys.size(); i++) {
+        hashes[i] = Hash(keys[i], hashSeed);
+        buckets[(hashes[i] >> 32) & bucketMask].push_back(i);
+    }
+
+    // Large buckets are the hardest to place, so they go first, while most slots are free
+    std::vector<uint32_t> order(buckets.size());
+    for (uint32_t b = 0; b < order.size(); b++)
+        order[b] = b;
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return buckets[a].size() > buckets[b].size(); });
+
+    seeds.assign(buckets.size(), 0);
+    slots.assign(slotMask + 1, NotFound);
+
+    std::vector<uint64_t> taken;
+
+    for (uint32_t b : order) {
+        const std::vector<uint32_t>& bucket = buckets[b];
+        if (bucket.empty())
+            break;
+
+        bool placed = false;
+
+        for (uint32_t seed = 0; seed < MaxSeed && !placed; seed++) {
+            taken.clear();
+            placed = true;
+
+            for (uint32_t i : bucket) {
+                const uint64_t slot = Slot(hashes[i], seed);
+
+                if (slots[slot] != NotFound || std::find(taken.begin(), taken.end(), slot) != taken.end()) {
+                    placed = false;
+                    break;
+                }
+                taken.push_back(slot);
+            }
+
+            if (placed) {
+                seeds[b] = seed;
+                for (size_t j = 0; j < bucket.size(); j++)
+                    slots[taken[j]] = bucket[j];
+            }
+        }
+
+        if (!placed)
+            return false;
+    }
+
+    return true;
+}
+
+KeyTable::KeyTable(std::span<const std::string_view> keys) {
+    if (keys.empty())
+        return;
+
+    // About 4 keys per bucket, and at least a fifth of the slots left empty
+    bucketMask = std::bit_ceil(std::max<size_t>(1, keys.size() / 4)) - 1;
+    slotMask = std::bit_ceil(keys.size() + keys.size() / 4) - 1;
+
+    while (!Build(keys)) {
+        hashSeed++;
+        slotMask = slotMask * 2 + 1;
+    }
+}
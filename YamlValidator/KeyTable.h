@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class KeyTable
+ * @brief Class that finds a key among a fixed set of keys with one hash and one comparison.
+ * @note A perfect hash, built once: the keys are split into buckets by their hash, and each bucket
+ *       gets a seed that sends its keys to slots no other key uses. Looking a key up hashes it once,
+ *       reads the seed of its bucket and then the one slot it can be in. The table only stores the
+ *       indices of the keys, so the caller compares the key it finds to the one it looked up.
+ */
+class KeyTable {
+public:
+    static constexpr uint32_t NotFound = UINT32_MAX; /// Returned by Find for a key that is not in the set.
+
+private:
+    std::vector<uint32_t> seeds;    /// Seed of each bucket.
+    std::vector<uint32_t> slots;    /// Index of the key in each slot, NotFound for an empty slot.
+    uint64_t hashSeed = 0;          /// Seed of the hash that picks the bucket.
+    uint64_t bucketMask = 0;        /// Number of buckets - 1, a power of two - 1.
+    uint64_t slotMask = 0;          /// Number of slots - 1, a power of two - 1.
+
+    /**
+     * @brief Hashes a key.
+     * @param key The key.
+     * @param seed Seed of the hash.
+     * @return The hash, 8 bytes of the key at a time.
+     */
+    static uint64_t Hash(std::string_view key, uint64_t seed) {
+        uint64_t hash = seed ^ (key.size() * 0x9E3779B97F4A7C15ull);
+        size_t i = 0;
+
+        for (; i + 8 <= key.size(); i += 8) {
+            uint64_t word;
+            std::memcpy(&word, key.data() + i, 8);
+            hash = (hash ^ word) * 0xBF58476D1CE4E5B9ull;
+            hash ^= hash >> 31;
+        }
+
+        uint64_t tail = 0;
+        if (i < key.size())
+            std::memcpy(&tail, key.data() + i, key.size() - i);
+        hash = (hash ^ tail) * 0x94D049BB133111EBull;
+        return hash ^ (hash >> 29);
+    }
+
+    /**
+     * @brief Gets the slot of a key from its hash and the seed of its bucket.
+     */
+    uint64_t Slot(uint64_t hash, uint32_t seed) const {
+        uint64_t mixed = (hash ^ (seed * 0x9E3779B97F4A7C15ull)) * 0xBF58476D1CE4E5B9ull;
+        return (mixed ^ (mixed >> 32)) & slotMask;
+    }
+
+    /**
+     * @brief Tries to give every bucket a seed with the current sizes and hash seed.
+     * @param keys The keys.
+     * @return True if every key got a slot of its own.
+     */
+    bool Build(std::span<const std::string_view> keys);
+
+public:
+    /**
+     * @brief Constructor for an empty KeyTable, that finds nothing.
+     */
+    KeyTable() = default;
+
+    /**
+     * @brief Constructor for KeyTable.
+     * @param keys The keys, without duplicates. Only read during the call.
+     */
+    explicit KeyTable(std::span<const std::string_view> keys);
+
+    /**
+     * @brief Finds the only key of the set that a key can be.
+     * @param key The key to look up.
+     * @return The index of that key in the set the table was built from, NotFound if there is none.
+     *         The caller has to compare the two keys, since keys outside the set also map to an index.
+     */
+    uint32_t Find(std::string_view key) const {
+        if (slots.empty())
+            return NotFound;
+
+        const uint64_t hash = Hash(key, hashSeed);
+        return slots[Slot(hash, seeds[(hash >> 32) & bucketMask])];
+    }
+};
@@ -1,5 +1,7 @@
 #include "Types.h"
 #include "Schema.h"
+#include "IncrementalDocument.h"
+#include "DocumentStream.h"
 
 #include <typeinfo>
 
@@ -17,9 +19,9 @@ std::string Schema::getTypeName(std::variant<SchemaValue, parser_types::YamlValu
             return "Null";
         else if (std::holds_alternative<parser_types::Timestamp>(yamlValueInstance))
             return "Timestamp";
-        else if (std::holds_alternative<std::shared_ptr<parser_types::Object>>(yamlValueInstance)) {
+        else if (std::holds_alternative<parser_types::Object*>(yamlValueInstance)) {
 
-            std::shared_ptr<parser_types::Object> yamlValueObject = std::get<std::shared_ptr<parser_types::Object>>(yamlValueInstance);
+            const parser_types::Object* yamlValueObject = std::get<parser_types::Object*>(yamlValueInstance);
 
             std::vector<std::string> keys = yamlValueObject->ExtractKeys();
 
@@ -37,8 +39,8 @@ std::string Schema::getTypeName(std::variant<SchemaValue, parser_types::YamlValu
 
             return name + "})";
         }
-        else if (std::holds_alternative<std::shared_ptr<parser_types::Array>>(yamlValueInstance)) {
-            std::shared_ptr<parser_types::Array> yamlValueArray = std::get<std::shared_ptr<parser_types::Array>>(yamlValueInstance);
+        else if (std::holds_alternative<parser_types::Array*>(yamlValueInstance)) {
+            const parser_types::Array* yamlValueArray = std::get<parser_types::Array*>(yamlValueInstance);
 
             std::string name = "Array({";
 
@@ -63,11 +65,11 @@ std::string Schema::getTypeName(std::variant<SchemaValue, parser_types::YamlValu
     SchemaValue schemaValueInstance = std::get<SchemaValue>(instance);
 
     if (std::holds_alternative<Either>(schemaValueInstance)) {
-        Either eitherInstance = std::get<Either>(schemaValueInstance);
+        const Either& eitherInstance = std::get<Either>(schemaValueInstance);
 
         std::string name = "Either<";
 
-        for (SchemaValue& eitherInstanceType : eitherInstance.values) {
+        for (const SchemaValue& eitherInstanceType : eitherInstance.GetValues()) {
             name += getTypeName(eitherInstanceType) + ",";
         }
 
@@ -121,105 +123,206 @@ std::string Schema::getTypeName(std::variant<SchemaValue, parser_types::YamlValu
     return "";
 };
 
-bool Schema::compareTypeToParserType(SchemaValue type, parser_types::YamlValue yamlInstance) {
-    if (std::holds_alternative<Either>(type)) {
-        Either eitherType = std::get<Either>(type);
+Schema::ObjectImplementation::ObjectImplementation(std::unordered_map<std::string, SchemaValue> values) : values(std::move(values)) {
+    std::vector<std::string_view> keys;
+    keys.reserve(this->values.size());
+    entries.reserve(this->values.size());
 
-        for (const SchemaValue& typesType : eitherType.values) {
-            if (compareTypeToParserType(typesType, yamlInstance))
-                return true;
-        }
-
-        return false;
-    }
-    else if (std::holds_alternative<std::shared_ptr<ObjectImplementation>>(type)) {
-        if (std::holds_alternative<std::shared_ptr<parser_types::Object>>(yamlInstance))
-            return true;
+    for (const auto& entry : this->values) {
+        keys.push_back(entry.first);
+        entries.push_back(&entry);
     }
-    else if (std::holds_alternative<std::shared_ptr<ArrayImplementation>>(type)) {
-        if (std::holds_alternative<std::shared_ptr<parser_types::Array>>(yamlInstance))
-            return true;
-    }
-    else if (std::holds_alternative<Type>(type)) {
-        Type typesType = std::get<Type>(type);
-
-        if (typesType == Schema::String && std::holds_alternative<parser_types::String>(yamlInstance))
-            return true;
-        else if (typesType == Schema::Number && std::holds_alternative<parser_types::Number>(yamlInstance))
-            return true;
-        else if (typesType == Schema::Boolean && std::holds_alternative<parser_types::Boolean>(yamlInstance))
-            return true;
-        else if (typesType == Schema::Null && std::holds_alternative<parser_types::Null>(yamlInstance))
-            return true;
-        else if (typesType == Schema::Timestamp && std::holds_alternative<parser_types::Timestamp>(yamlInstance))
-            return true;
+
+    table = KeyTable(keys);
+}
+
+uint32_t Schema::TypeMaskOf(const SchemaValue& value) {
+    if (const Type* type = std::get_if<Type>(&value)) {
+        switch (*type) {
+        case String:    return CompiledSchema::TypeBitOf<parser_types::String>();
+        case Number:    return CompiledSchema::TypeBitOf<parser_types::Number>();
+        case Boolean:   return CompiledSchema::TypeBitOf<parser_types::Boolean>();
+        case Null:      return CompiledSchema::TypeBitOf<parser_types::Null>();
+        case Timestamp: return CompiledSchema::TypeBitOf<parser_types::Timestamp>();
+        }
+        return 0;
     }
 
+    if (const Either* either = std::get_if<Either>(&value))
+        return either->GetTypeMask();
 
-    return false;
-};
+    if (std::holds_alternative<std::shared_ptr<ArrayImplementation>>(value))
+        return CompiledSchema::TypeBitOf<parser_types::Array*>();
 
-Schema::ValidationResult Schema::GetValidationError(std::optional<std::variant<Schema::SchemaError::ArrayError, SchemaError::ObjectError>> errorInformation, ErrorType errorType, std::string message) {
-    return Schema::ValidationResult(Schema::ValidationResult::ValidationError(Schema::SchemaError(errorInformation, errorType, message)));
+    return CompiledSchema::TypeBitOf<parser_types::Object*>();
+}
+
+Schema::ValidationResult Schema::GetValidationError(std::optional<std::variant<Schema::SchemaError::ArrayError, SchemaError::ObjectError>> errorInformation, ErrorType errorType) {
+    return Schema::ValidationResult(Schema::ValidationResult::ValidationError(Schema::SchemaError(errorInformation, errorType)));
 }
 
 Schema::ValidationResult Schema::GetValidationErrorMismatch(std::optional<std::variant<SchemaError::ArrayError, SchemaError::ObjectError>> errorInformation, SchemaValue expected, parser_types::YamlValue got) {
-    std::string expectedTypeName = getTypeName(expected);
-    std::string gotTypeName = getTypeName(got);
+    return Schema::ValidationResult(Schema::ValidationResult::ValidationError(Schema::SchemaError(errorInformation, ErrorType::TypeMismatch, expected, got)));
+}
 
-    std::string message = std::format("TypeMismatch: Expected {} but got {}", expectedTypeName, gotTypeName);
-    
-    if (errorInformation.has_value()) {
-        std::variant<SchemaError::ArrayError, SchemaError::ObjectError> errorInformationValue = errorInformation.value();
+Schema::ValidationResult Schema::GetValidationErrorUnexpected(std::optional<std::variant<SchemaError::ArrayError, SchemaError::ObjectError>> errorInformation, parser_types::YamlValue unexpected) {
+    return Schema::ValidationResult(Schema::ValidationResult::ValidationError(Schema::SchemaError(errorInformation, ErrorType::UnexpectedValue, std::nullopt, unexpected)));
+}
 
-        std::string at = "Null";
+std::string Schema::SchemaError::GetMessage() const {
+    if (errorType == ErrorType::UnexpectedValue && got.has_value())
+        return "UnexpectedValue: " + getTypeName(got.value());
+
+    if (errorType != ErrorType::TypeMismatch || !expected.has_value())
+        return "";
 
-        parser_types::YamlValue errorRoot = Null;
+    // Errors found while streaming have no value to show
+    if (!got.has_value()) {
+        std::string message = "TypeMismatch: Expected " + getTypeName(expected.value());
+
+        if (const ArrayError* arrayError = information.has_value() ? std::get_if<ArrayError>(&information.value()) : nullptr) {
+            if (arrayError->index.has_value())
+                message += " at '" + std::to_string(arrayError->index.value()) + "'";
+        }
+        else if (information.has_value()) {
+            const ObjectError& objectError = std::get<ObjectError>(information.value());
+
+            if (objectError.key.has_value())
+                message += " at '" + objectError.key.value() + "'";
+        }
+
+        return message;
+    }
 
-        if (std::holds_alternative<SchemaError::ArrayError>(errorInformation.value())) {
-            SchemaError::ArrayError errorInformationArray = std::get<SchemaError::ArrayError>(errorInformationValue);
+    std::string message = "TypeMismatch: Expected " + getTypeName(expected.value()) + " but got " + getTypeName(got.value());
 
-            errorRoot = errorInformationArray.errorRoot;
+    if (information.has_value()) {
+        std::string at = "Null";
 
+        parser_types::YamlValue errorRoot = parser_types::Null();
 
-            if(errorInformationArray.index.has_value())
-                at = std::to_string(errorInformationArray.index.value());
+        if (const ArrayError* arrayError = std::get_if<ArrayError>(&information.value())) {
+            if (arrayError->errorRoot != nullptr)
+                errorRoot = arrayError->errorRoot.get();
 
+            if (arrayError->index.has_value())
+                at = std::to_string(arrayError->index.value());
         }
         else {
-            SchemaError::ObjectError errorInformationObject = std::get<SchemaError::ObjectError>(errorInformationValue);
+            const ObjectError& objectError = std::get<ObjectError>(information.value());
 
-            errorRoot = errorInformationObject.errorRoot;
+            if (objectError.errorRoot != nullptr)
+                errorRoot = objectError.errorRoot.get();
 
-            if (errorInformationObject.key.has_value())
-                at = errorInformationObject.key.value();
+            if (objectError.key.has_value())
+                at = objectError.key.value();
         }
-        
-        message += std::format(" at '{}' in {}", at, getTypeName(errorRoot));
+
+        message += " at '" + at + "' in " + getTypeName(errorRoot);
     }
 
-    
-    return GetValidationError(errorInformation, ErrorType::TypeMismatch, message);
+    return message;
 }
 
-Schema::ValidationResult Schema::GetValidationErrorUnexpected(std::optional<std::variant<SchemaError::ArrayError, SchemaError::ObjectError>> errorInformation, parser_types::YamlValue unexpected) {
-    std::string unexpectedTypeName = getTypeName(unexpected);
 
-    std::string message = std::format("UnexpectedValue: {}", unexpectedTypeName);
+#define GetValidationSuccess ValidationResult(ValidationResult::ValidationSuccess())
+
+Schema::ValidationResult Schema::ValidateFromFile(const std::string& path)
+{
+    if (cache != nullptr)
+        return ValidateFile(path, *compiled, nullptr, cache.get());
 
-    return GetValidationError(errorInformation, ErrorType::UnexpectedValue, message);
+    return ValidateParserResult(ParseYaml(path));
 }
 
+Schema::ValidationResult Schema::ValidateFromFile(const std::string& path, ThreadPool& pool, size_t grainSize)
+{
+    return ValidateFile(path, *compiled, nullptr, cache.get(), &pool, grainSize);
+}
 
-#define GetValidationSuccess ValidationResult(ValidationResult::ValidationSuccess())
+size_t Schema::ValidateDocuments(DocumentStream& stream, const std::function<void(const DocumentResult&)>& sink)
+{
+    size_t invalid = 0;
 
-Schema::ValidationResult Schema::ValidateFromFile(const std::string& path)
+    // Each entry, and the Document it owns, is released before the next one is read
+    while (std::optional<DocumentStream::Entry> entry = stream.Next()) {
+        DocumentResult document = { entry->index, entry->line, ValidateParserResult(entry->result) };
+
+        if (std::holds_alternative<ValidationResult::ValidationError>(document.result.result))
+            invalid++;
+
+        sink(document);
+    }
+
+    return invalid;
+}
+
+size_t Schema::ValidateDocumentsFromFile(const std::string& path, const std::function<void(const DocumentResult&)>& sink)
+{
+    std::optional<DocumentStream> stream = DocumentStream::FromFile(path);
+
+    if (!stream.has_value()) {
+        sink({ 0, 0, ValidationResult(ValidationResult::ValidationError(ParserError(::ErrorType::FileOpenError, 0, 0))) });
+        return 1;
+    }
+
+    return ValidateDocuments(stream.value(), sink);
+}
+
+Schema::ErrorList Schema::ValidateAllFromFile(const std::string& path, const CollectOptions& options)
+{
+    return ValidateAllParserResult(ParseYaml(path), options);
+}
+
+Schema::ErrorList Schema::ValidateAllText(std::string_view yaml, const CollectOptions& options)
+{
+    return ValidateAllParserResult(ParseYamlText(yaml), options);
+}
+
+Schema::ErrorList Schema::ValidateAllParserResult(const ParserResult& result, const CollectOptions& options)
+{
+    if (std::optional<ParserError> error = result.GetIfError()) {
+        ErrorList list;
+        ErrorCollector collector = { options, list };
+
+        collector.Add(ValidationResult(ValidationResult::ValidationError(error.value())));
+        return list;
+    }
+
+    return Schema::ValidateAll(result.GetResult(), *compiled, options);
+}
+
+Schema::ValidationResult Schema::ValidateText(std::string_view yaml)
+{
+    return ValidateParserResult(ParseYamlText(yaml));
+}
+
+Schema::ValidationResult Schema::ValidateText(std::string_view yaml, std::pmr::memory_resource* resource)
+{
+    return ValidateParserResult(ParseYamlText(yaml, resource));
+}
+
+Schema::ValidationResult Schema::Validate(IncrementalDocument& document)
 {
-    ParserResult result = ParseYaml(path);
+    if (document.error.has_value())
+        return ValidationResult(ValidationResult::ValidationError(document.error.value()));
+
+    // Results are only reused for the schema they were validated against
+    if (document.memo.compiled != compiled) {
+        document.memo.Clear();
+        document.memo.compiled = compiled;
+    }
+
+    return Schema::Validate(document.root.value(), *compiled, document.memo);
+}
 
+Schema::ValidationResult Schema::ValidateParserResult(const ParserResult& result)
+{
     if (std::optional<ParserError> errorOptional = result.GetIfError()) {
         if (errorOptional.has_value()) {
-            return ValidationResult(ValidationResult::ValidationError(errorOptional.value()));
+            ValidationResult validation = ValidationResult(ValidationResult::ValidationError(errorOptional.value()));
+            validation.AddStatistics(result.GetStatistics());
+            return validation;
         }
     }
 
@@ -227,23 +330,25 @@ Schema::ValidationResult Schema::ValidateFromFile(const std::string& path)
         if (yamlOptional.has_value()) {
             parser_types::Yaml yaml = yamlOptional.value();
 
-            return Schema::Validate(yaml, this->schema);
+            ValidationResult validation = Schema::Validate(yaml, *compiled);
+            validation.AddStatistics(result.GetStatistics());
+            return validation;
         }
     }
 
     return GetValidationError(std::nullopt, Schema::ErrorType::UnknownError);
 }
 
-Schema::ValidationResult Schema::ValidateCompare(SchemaValue schemaValue, YamlValue yamlValue, ValidationResult mismatchError) {
+Schema::ValidationResult Schema::ValidateCompare(const SchemaValue& schemaValue, const YamlValue& yamlValue, const ErrorLocation& location) {
     if (std::holds_alternative<std::shared_ptr<ObjectImplementation>>(schemaValue)) {
         //recursion! (object)
 
         //yamlValue also needs to be of object type or the types don't match
-        if (!std::holds_alternative<std::shared_ptr<parser_types::Object>>(yamlValue))
-            return mismatchError;// GetValidationErrorUnexpected(SchemaError::ObjectError(yamlObject, yamlObjectKey), yamlValue);
+        if (!std::holds_alternative<parser_types::Object*>(yamlValue))
+            return GetValidationErrorMismatch(location.ToInformation(), schemaValue, yamlValue);
         //return GetValidationError(SchemaError::ObjectError(yamlObject, yamlObjectKey), Schema::ErrorType::UnexpectedValue);  //ValidationUnexpectedValue;
 
-        ValidationResult result = Schema::Validate(std::get<std::shared_ptr<parser_types::Object>>(yamlValue), std::get<std::shared_ptr<ObjectImplementation>>(schemaValue));
+        ValidationResult result = Schema::Validate(location.Share(std::get<parser_types::Object*>(yamlValue)), std::get<std::shared_ptr<ObjectImplementation>>(schemaValue));
 
         //if we get an error return, otherwise the object is good and we can check the other keys
         if (std::holds_alternative<ValidationResult::ValidationError>(result.result))
@@ -253,10 +358,10 @@ Schema::ValidationResult Schema::ValidateCompare(SchemaValue schemaValue, YamlVa
     else if (std::holds_alternative<std::shared_ptr<ArrayImplementation>>(schemaValue)) {
         //recursion! (array)
 
-        if (!std::holds_alternative<std::shared_ptr<parser_types::Array>>(yamlValue))
-            return mismatchError;// GetValidationErrorUnexpected(SchemaError::ObjectError(yamlObject, yamlObjectKey), yamlValue);
+        if (!std::holds_alternative<parser_types::Array*>(yamlValue))
+            return GetValidationErrorMismatch(location.ToInformation(), schemaValue, yamlValue);
 
-        ValidationResult result = Schema::Validate(std::get<std::shared_ptr<parser_types::Array>>(yamlValue), std::get<std::shared_ptr<ArrayImplementation>>(schemaValue));
+        ValidationResult result = Schema::Validate(location.Share(std::get<parser_types::Array*>(yamlValue)), std::get<std::shared_ptr<ArrayImplementation>>(schemaValue));
 
         if (std::holds_alternative<ValidationResult::ValidationError>(result.result))
             return result;
@@ -264,21 +369,39 @@ Schema::ValidationResult Schema::ValidateCompare(SchemaValue schemaValue, YamlVa
     else if (std::holds_alternative<Either>(schemaValue)) {
         //the object value does not have the right type
 
-        Either schemaObjectEither = std::get<Either>(schemaValue);
+        const Either& schemaObjectEither = std::get<Either>(schemaValue);
+
+        if (!Schema::compareTypeToParserType(schemaValue, yamlValue))
+            return GetValidationErrorMismatch(location.ToInformation(), schemaValue, yamlValue);
+
+        // an object only has to match the alternative its discriminator value picks, if it picks one
+        if (!schemaObjectEither.discriminator.empty() && std::holds_alternative<parser_types::Object*>(yamlValue)) {
+            std::optional<YamlValue> discriminatorValue = std::get<parser_types::Object*>(yamlValue)->Get(schemaObjectEither.discriminator);
+            std::optional<std::string_view> text = discriminatorValue.has_value() ? DiscriminatorText(discriminatorValue.value()) : std::nullopt;
 
-        if (!Schema::compareTypeToParserType(schemaObjectEither, yamlValue))
-            return mismatchError;// GetValidationErrorMismatch(SchemaError::ObjectError(yamlObject, yamlObjectKey), std::get<Either>(schemaValue), yamlValue);
+            if (text.has_value()) {
+                auto picked = schemaObjectEither.mapping.find(std::string(text.value()));
+
+                if (picked != schemaObjectEither.mapping.end() && picked->second < schemaObjectEither.GetValues().size()) {
+                    ValidationResult result = ValidateCompare(schemaObjectEither.GetValues()[picked->second], yamlValue, location);
+
+                    if (std::holds_alternative<ValidationResult::ValidationError>(result.result))
+                        return GetValidationErrorMismatch(location.ToInformation(), schemaValue, yamlValue);
+                    return GetValidationSuccess;
+                }
+            }
+        }
 
         bool ok = false;
 
-        for (SchemaValue& schemaObjectEitherValue : schemaObjectEither.values) {
+        for (const SchemaValue& schemaObjectEitherValue : schemaObjectEither.GetValues()) {
 
             if (!Schema::compareTypeToParserType(schemaObjectEitherValue, yamlValue))
                 continue;
 
             if (std::holds_alternative<std::shared_ptr<ObjectImplementation>>(schemaObjectEitherValue)) {
                 //because of the previous compareTypeToParserType check we know that yamlValue must be an Object.
-                ValidationResult result = Schema::Validate(std::get<std::shared_ptr<parser_types::Object>>(yamlValue), std::get<std::shared_ptr<ObjectImplementation>>(schemaObjectEitherValue));
+                ValidationResult result = Schema::Validate(location.Share(std::get<parser_types::Object*>(yamlValue)), std::get<std::shared_ptr<ObjectImplementation>>(schemaObjectEitherValue));
 
                 //if we get an error return, otherwise the object is good and we can check the other keys
                 if (std::holds_alternative<ValidationResult::ValidationSuccess>(result.result)) {
@@ -288,7 +411,7 @@ Schema::ValidationResult Schema::ValidateCompare(SchemaValue schemaValue, YamlVa
             }
             else if (std::holds_alternative<std::shared_ptr<ArrayImplementation>>(schemaObjectEitherValue)) {
                 //because of the previous compareTypeToParserType check we know that yamlValue must be an Object.
-                ValidationResult result = Schema::Validate(std::get<std::shared_ptr<parser_types::Array>>(yamlValue), std::get<std::shared_ptr<ArrayImplementation>>(schemaObjectEitherValue));
+                ValidationResult result = Schema::Validate(location.Share(std::get<parser_types::Array*>(yamlValue)), std::get<std::shared_ptr<ArrayImplementation>>(schemaObjectEitherValue));
 
                 //if we get an error return, otherwise the object is good and we can check the other keys
                 if (std::holds_alternative<ValidationResult::ValidationSuccess>(result.result)) {
@@ -303,10 +426,10 @@ Schema::ValidationResult Schema::ValidateCompare(SchemaValue schemaValue, YamlVa
         }
 
         if (!ok)
-            return mismatchError;// GetValidationErrorMismatch(SchemaError::ObjectError(yamlObject, yamlObjectKey), std::get<Either>(schemaValue), yamlValue);
+            return GetValidationErrorMismatch(location.ToInformation(), schemaValue, yamlValue);
     }  //the object value does not have the right type
-    else if (!Schema::compareTypeToParserType(std::get<Type>(schemaValue), yamlValue))
-        return mismatchError;// GetValidationErrorMismatch(SchemaError::ObjectError(yamlObject, yamlObjectKey), std::get<Type>(schemaValue), yamlValue);
+    else if (!Schema::compareTypeToParserType(schemaValue, yamlValue))
+        return GetValidationErrorMismatch(location.ToInformation(), schemaValue, yamlValue);
     
     return GetValidationSuccess;
 }
@@ -321,34 +444,21 @@ Schema::ValidationResult Schema::Validate(
         if (!std::holds_alternative<std::shared_ptr<ObjectImplementation>>(schema))
             return  GetValidationError(std::nullopt, ErrorType::UnexpectedValue);//error or something because the base of the schema is not an object while the yaml is which almost certainly means that the yaml does not include schema things which are by default required
         
-        std::shared_ptr<parser_types::Object> yamlObject = std::get<std::shared_ptr<parser_types::Object>>(yaml);
-        std::shared_ptr<ObjectImplementation> schemaObject = std::get<std::shared_ptr<ObjectImplementation>>(schema);
-
-        std::vector<std::string> yamlObjectKeys = yamlObject->ExtractKeys();
-        std::vector<std::string> schemaObjectKeys = schemaObject->ExtractKeys();
+        parser_types::Object* yamlObject = std::get<std::shared_ptr<parser_types::Object>>(yaml).get();
+        const std::shared_ptr<ObjectImplementation>& schemaObject = std::get<std::shared_ptr<ObjectImplementation>>(schema);
 
-        for (std::string& yamlObjectKey : yamlObjectKeys) {
-            if (!schemaObject->ContainsKey(yamlObjectKey))
+        // Keys the schema does not know are allowed, so each key of the document is looked up once
+        for (const auto& [yamlObjectKey, yamlObjectValue] : *yamlObject) {
+            const SchemaValue* schemaObjectValue = schemaObject->Find(yamlObjectKey);
+            if (schemaObjectValue == nullptr)
                 continue;
 
-            std::optional<YamlValue> yamlObjectOptionalValue = yamlObject->Get(yamlObjectKey);
-            std::optional<SchemaValue> schemaObjectOptionalValue = schemaObject->Get(yamlObjectKey);
-
-            if (!yamlObjectOptionalValue.has_value() || !schemaObjectOptionalValue.has_value())
-                return GetValidationError(SchemaError::ObjectError(yamlObject, yamlObjectKey), Schema::ErrorType::UnknownError); //ValidationUnknownError;
-
-            YamlValue yamlObjectValue = yamlObjectOptionalValue.value();
-            SchemaValue schemaObjectValue = schemaObjectOptionalValue.value();
-
-            ValidationResult mismatchError = GetValidationErrorMismatch(SchemaError::ObjectError(yamlObject, yamlObjectKey), schemaObjectValue, yamlObjectValue);
-
-            ValidationResult result = ValidateCompare(schemaObjectValue, yamlObjectValue, mismatchError);
+            ValidationResult result = ValidateCompare(*schemaObjectValue, yamlObjectValue, ErrorLocation(yaml, yamlObject, yamlObjectKey));
 
             if (std::holds_alternative<ValidationResult::ValidationError>(result.result))
                 return result;
         }
 
-
         return GetValidationSuccess;
     }
 
@@ -357,29 +467,18 @@ Schema::ValidationResult Schema::Validate(
     if (!std::holds_alternative<std::shared_ptr<ArrayImplementation>>(schema))
         return GetValidationError(std::nullopt, Schema::ErrorType::UnexpectedValue);
 
-    std::shared_ptr<ArrayImplementation> schemaArray = std::get<std::shared_ptr<ArrayImplementation>>(schema);
-    SchemaValue schemaArrayType = schemaArray->type; //the type that each element of the array needs to be. (can't be object or array)
-
-    std::shared_ptr<parser_types::Array> yamlArray = std::get<std::shared_ptr<parser_types::Array>>(yaml);
-
-    for (int i = 0; i < yamlArray->Size(); i++) {
-        std::optional<parser_types::YamlValue> yamlArrayValueOptional = yamlArray->Get(i);
-
-        if (yamlArrayValueOptional.has_value()) {
-            parser_types::YamlValue yamlArrayValue = yamlArrayValueOptional.value();
-
-            //array and object are not allowed for now.
+    const std::shared_ptr<ArrayImplementation>& schemaArray = std::get<std::shared_ptr<ArrayImplementation>>(schema);
+    const SchemaValue& schemaArrayType = schemaArray->type; //the type that each element of the array needs to be. (can't be object or array)
 
-            ValidationResult mismatchError = GetValidationErrorMismatch(SchemaError::ArrayError(yamlArray, i), schemaArrayType, yamlArrayValue);
+    parser_types::Array* yamlArray = std::get<std::shared_ptr<parser_types::Array>>(yaml).get();
 
-            ValidationResult result = ValidateCompare(schemaArrayType, yamlArrayValue, mismatchError);
+    // Neither the schema nor the values are copied, so a valid array allocates nothing here
+    int i = 0;
+    for (const parser_types::YamlValue& yamlArrayValue : *yamlArray) {
+        ValidationResult result = ValidateCompare(schemaArrayType, yamlArrayValue, ErrorLocation(yaml, yamlArray, i++));
 
-            if (std::holds_alternative<ValidationResult::ValidationError>(result.result))
-                return result;
-
-        }
-        else//should never happen but still needs to be handled
-            return GetValidationError(std::nullopt, Schema::ErrorType::UnknownError);
+        if (std::holds_alternative<ValidationResult::ValidationError>(result.result))
+            return result;
     }
 
     return GetValidationSuccess;
@@ -1,17 +1,29 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <map>
+#include <algorithm>
 #include <vector>
 #include <variant>
 #include <unordered_map>
 #include <iostream>
 #include <fstream>
 #include <typeinfo>
-#include <format>
+#include <cstdint>
+#include <span>
+#include <filesystem>
+#include <atomic>
+#include <functional>
 
 #include "Types.h"
 #include "YamlParser.h"
+#include "KeyTable.h"
+
+class ThreadPool;
+class ValidationCache;
+class IncrementalDocument;
+class DocumentStream;
 
 class Schema {
 public:
@@ -49,10 +61,60 @@ public:
      *        Is used to allow for a yaml value to be of different types.
      */
     struct Either {
-        std::vector<SchemaValue> values; /// The different value-types to allow for. 
+    private:
+        std::vector<SchemaValue> values; /// The different value-types to allow for. Fixed at construction, so that typeMask stays right.
+        uint32_t typeMask = 0;           /// The parser types that at least one of the values allows, see CompiledSchema::TypeBit.
+
+        /**
+         * @brief Computes typeMask from values.
+         */
+        void ComputeTypeMask() {
+            for (const SchemaValue& value : values)
+                typeMask |= TypeMaskOf(value);
+        }
+
+    public:
+        std::string discriminator;       /// Key of object values whose value picks the one alternative to validate against, empty if none.
+        std::unordered_map<std::string, size_t> mapping; /// Values of the discriminator key, with the index in values of the alternative each one picks.
 
         template<typename... Args>
-        Either(Args... args) : values({ args... }) { };
+        Either(Args... args) : values({ args... }) {
+            ComputeTypeMask();
+        };
+
+        /**
+         * @brief Constructor for an Either of values that are only known at run time.
+         * @param values The different value-types to allow for.
+         */
+        Either(std::vector<SchemaValue> values) : values(std::move(values)) {
+            ComputeTypeMask();
+        }
+
+        /**
+         * @brief Gets the different value-types to allow for.
+         */
+        const std::vector<SchemaValue>& GetValues() const { return values; }
+
+        /**
+         * @brief Gets the parser types that at least one of the values allows, see CompiledSchema::TypeBit.
+         */
+        uint32_t GetTypeMask() const { return typeMask; }
+
+        /**
+         * @brief Makes objects be validated against only the alternative that the value of a key picks,
+         *        instead of against each alternative in turn until one matches.
+         * @param key The key, eg. "type".
+         * @param mapping The values of key, with the index in values of the alternative each one picks.
+         * @note An object that fails the picked alternative fails the Either, even if another alternative
+         *       would match it. Objects without the key, or with a value not in mapping, are still
+         *       validated against each alternative in turn.
+         * @return This Either.
+         */
+        Either& Discriminate(std::string key, std::unordered_map<std::string, size_t> mapping) {
+            discriminator = std::move(key);
+            this->mapping = std::move(mapping);
+            return *this;
+        }
     };
 
 private:
@@ -79,26 +141,47 @@ private:
      * @brief Struct representing an Object with an std::string as key and SchemaValue as value.
      */
     struct ObjectImplementation {
-    public:
-        std::unordered_map<std::string,SchemaValue> values;
+    private:
+        std::unordered_map<std::string,SchemaValue> values; /// Fixed at construction, since entries, table and compiled schemas point into it.
+        std::vector<const std::pair<const std::string, SchemaValue>*> entries; /// The entries of values, in the order table was built from.
+        KeyTable table;                                                       /// Finds the entry of a key with one hash.
 
+    public:
         /**
          * @brief Constructor for ObjectImplementation.
          * @param values An unordered map with an std::string as key and SchemaValue as value.
          */
-        ObjectImplementation(std::unordered_map<std::string, SchemaValue> values) : values(values) {};
-        
+        ObjectImplementation(std::unordered_map<std::string, SchemaValue> values);
+
+        ObjectImplementation(const ObjectImplementation&) = delete;
+        ObjectImplementation& operator=(const ObjectImplementation&) = delete;
+
+        /**
+         * @brief Gets the keys of the object with the SchemaValue of each.
+         */
+        const std::unordered_map<std::string, SchemaValue>& GetValues() const { return values; }
+
+        /**
+         * @brief Finds the SchemaValue stored for the key, without copying either.
+         * @param key The key to find the value of.
+         * @return Pointer to the SchemaValue, nullptr if the object does not contain the key.
+         */
+        const SchemaValue* Find(std::string_view key) const {
+            const uint32_t index = table.Find(key);
+            if (index == KeyTable::NotFound || entries[index]->first != key)
+                return nullptr;
+            return &entries[index]->second;
+        }
+
         /**
          * @brief Gets the SchemaValue stored for the key if the key exists.
          * @param key The key to get the value with.
          * @return An std::optional containing a SchemaValue if a value
          *         associated with the key exists, std::nullopt otherwise.
          */
-        std::optional<SchemaValue> Get(const std::string& key) const {
-            auto it = values.find(key);
-            if (it != values.end()) {
-                return it->second;
-            }
+        std::optional<SchemaValue> Get(std::string_view key) const {
+            if (const SchemaValue* value = Find(key))
+                return *value;
             return std::nullopt;
         }
 
@@ -107,8 +190,8 @@ private:
          * @param key The key to check whether or not it exists in the object.
          * @return True if the object contains the key, false otherwise.
          */
-        bool ContainsKey(const std::string& key) const {
-            return values.find(key) != values.end();
+        bool ContainsKey(std::string_view key) const {
+            return Find(key) != nullptr;
         }
 
         /**
@@ -142,7 +225,7 @@ public:
      * @return Shared pointer of an ObjectImplementation.
      */
     static std::shared_ptr<ObjectImplementation> CreateObject(std::unordered_map<std::string, SchemaValue> values) {
-        return std::make_shared<ObjectImplementation>(ObjectImplementation(values));
+        return std::make_shared<ObjectImplementation>(std::move(values));
     };
 
 private:
@@ -155,6 +238,20 @@ private:
      */
     static std::string getTypeName(std::variant<SchemaValue, parser_types::YamlValue> instance);
 
+    /**
+     * @brief Gets the parser types a SchemaValue allows.
+     * @param value The SchemaValue. An Either gives the mask computed when it was constructed.
+     * @return A mask with the CompiledSchema::TypeBit of each allowed parser type set.
+     */
+    static uint32_t TypeMaskOf(const SchemaValue& value);
+
+    /**
+     * @brief Gets the text of a scalar, to compare it with the values of a discriminator, see Either::Discriminate.
+     * @param value The scalar.
+     * @return The text of a String, Number or Timestamp, std::nullopt for any other value.
+     */
+    static std::optional<std::string_view> DiscriminatorText(const parser_types::YamlValue& value);
+
     /**
      * @brief Checks whether or not the provided YamlValue instance has 
      *		  an equivalent Type based on the type parameter.
@@ -162,9 +259,12 @@ private:
      * @param yamlInstance Instance of YamlValue to compare.
      * @note If the type parameter is of instance Either then the return will be true if the 
      *		 yamlInstance is equivalent to any of the contained types.
+     *       Only compares the type masks, so neither argument is copied or walked.
      * @return True if the YamlValue instance has an equivalent Type.
      */
-    static bool compareTypeToParserType(SchemaValue type, parser_types::YamlValue yamlInstance);
+    static bool compareTypeToParserType(const SchemaValue& type, const parser_types::YamlValue& yamlInstance) {
+        return (TypeMaskOf(type) & CompiledSchema::TypeBit(yamlInstance)) != 0;
+    }
 public:
 
     /**
@@ -187,7 +287,7 @@ public:
          * @brief Struct representing an array error.
          */
         struct ArrayError {
-            std::shared_ptr<parser_types::Array> errorRoot; /// The parser Array root of the error.
+            std::shared_ptr<parser_types::Array> errorRoot; /// The parser Array root of the error, nullptr when validated without building a Document.
             std::optional<int> index; /// The index of the parser Array where the error occured.
 
             /**
@@ -199,7 +299,7 @@ public:
         };
 
         struct ObjectError {
-            std::shared_ptr<parser_types::Object> errorRoot; /// The parser Object root of the error.
+            std::shared_ptr<parser_types::Object> errorRoot; /// The parser Object root of the error, nullptr when validated without building a Document.
             std::optional<std::string> key; /// The key of the parser Object where the error occured.
 
             /**
@@ -212,16 +312,26 @@ public:
 
         std::optional<std::variant<ArrayError, ObjectError>> information; /// Specific information about the error based on if the error occurs in an parser Array or parser Object.
         ErrorType errorType; /// The type of error.
-        std::string message; /// String containing stringified message based on information and errorType.
+        std::optional<SchemaValue> expected; /// The SchemaValue that the yaml value was validated against, if any.
+        std::optional<parser_types::YamlValue> got; /// The yaml value that caused the error, if any.
 
         /**
          * @brief Constructor for SchemaError.
          * @param information Specific information about the error based on if the error occurs 
          *					  in an parser Array or parser Object.
          * @param errorType The type of error.
-         * @param message String containing message based on information and errorType.
+         * @param expected The SchemaValue that the yaml value was validated against.
+         * @param got The yaml value that caused the error.
+         */
+        SchemaError(std::optional<std::variant<ArrayError, ObjectError>> information, ErrorType errorType, std::optional<SchemaValue> expected = std::nullopt, std::optional<parser_types::YamlValue> got = std::nullopt) : information(information), errorType(errorType), expected(expected), got(got) {};
+
+        /**
+         * @brief Builds a message based on information and errorType.
+         * @note The message is only rendered when asked for, so failed alternatives
+         *       that are discarded during validation never pay for formatting.
+         * @return String containing the stringified error.
          */
-        SchemaError(std::optional<std::variant<ArrayError, ObjectError>> information, ErrorType errorType, std::string message) : information(information), errorType(errorType), message(message) {};
+        std::string GetMessage() const;
     };
 
     /**
@@ -254,37 +364,497 @@ public:
         };
 
         std::variant<ValidationError, ValidationSuccess> result; /// ValidationError or ValidationSuccess with appropriate information
+        YAML_VALIDATOR_NO_UNIQUE_ADDRESS StatisticsSlot<> statistics; /// What reading, parsing and validating the document took, when Statistics are collected.
 
         /**
          * @brief Constructor for ValidationResult.
          * @param result ValidationError or ValidationSuccess with appropriate information.
          */
         ValidationResult(std::variant<ValidationError, ValidationSuccess> result) : result(result) { }
+
+        /**
+         * @brief Gets the Statistics of the document.
+         * @return The Statistics, all 0 unless YAML_VALIDATOR_STATISTICS is defined.
+         */
+        const Statistics& GetStatistics() const { return statistics.Get(); }
+
+        /**
+         * @brief Adds to the Statistics of the document. Does nothing unless YAML_VALIDATOR_STATISTICS is defined.
+         * @param other The Statistics to add, eg. those of the parse.
+         */
+        void AddStatistics(const Statistics& other) {
+            if constexpr (Statistics::Enabled) {
+                Statistics sum = statistics.Get();
+                sum += other;
+                statistics.Set(sum);
+            }
+        }
+
+        /**
+         * @brief Sums up the Statistics of many documents, eg. the results of ValidateFiles.
+         * @param results The results to sum up.
+         * @return The sum, all 0 unless YAML_VALIDATOR_STATISTICS is defined.
+         */
+        static Statistics SumStatistics(std::span<const ValidationResult> results) {
+            Statistics sum;
+            for (const ValidationResult& result : results)
+                sum += result.GetStatistics();
+            return sum;
+        }
+    };
+
+    /**
+     * @struct CollectOptions
+     * @brief Struct representing how many errors ValidateAll collects and where it reports them.
+     */
+    struct CollectOptions {
+        size_t maxErrors = 100; /// Validation stops once this many errors have been collected and another one is found.
+        std::function<void(const ValidationResult::ValidationError&)> sink; /// Optional, called with each collected error as soon as it is found.
+    };
+
+    /**
+     * @struct ErrorList
+     * @brief Struct representing every error ValidateAll found, in document order.
+     */
+    struct ErrorList {
+        std::vector<ValidationResult::ValidationError> errors; /// The collected errors, at most CollectOptions::maxErrors.
+        bool truncated = false; /// True if there were more errors than maxErrors and validation stopped early.
+
+        /**
+         * @brief Checks whether the document matched the schema.
+         * @return True if no errors were found, including ones left out because maxErrors was reached.
+         */
+        bool IsValid() const { return errors.empty() && !truncated; }
+    };
+
+    /**
+     * @struct DocumentResult
+     * @brief Struct representing the result of validating one document of a multi-document stream.
+     */
+    struct DocumentResult {
+        size_t index;               /// Index of the document in the stream, from 0, not counting empty ones.
+        long line;                  /// Line of the stream where the content of the document starts.
+        ValidationResult result;    /// ValidationError or ValidationSuccess of the document.
+    };
+
+    /**
+     * @struct CompiledSchema
+     * @brief Flat, index-addressed form of a schema tree produced by Schema::Compile.
+     *        Nodes, object keys and Either alternatives each live in one contiguous vector
+     *        and refer to each other by index, so validating against it never copies a
+     *        SchemaValue or touches a shared_ptr refcount.
+     */
+    struct CompiledSchema {
+        /**
+         * @enum NodeKind
+         * @brief Enum representing what a compiled node checks besides its typeMask.
+         */
+        enum NodeKind : uint8_t {
+            ScalarNode,     /// Only the typeMask is checked.
+            ArrayNode,      /// Every item is validated against node `first`.
+            ObjectNode,     /// Keys [first, first + count) are looked up in `keys`.
+            EitherNode,     /// Alternatives [first, first + count) are looked up in `alternatives`.
+        };
+
+        static constexpr uint32_t NoNode = UINT32_MAX; /// Stands for no node, or no discriminator.
+
+        /**
+         * @struct Node
+         * @brief Struct representing a single compiled SchemaValue.
+         */
+        struct Node {
+            NodeKind kind;                  /// What the node checks besides its typeMask.
+            uint32_t typeMask;              /// Bit i is set if a YamlValue holding alternative i is admitted.
+            uint32_t first;                 /// Item node, first key or first alternative depending on kind.
+            uint32_t count;                 /// Number of keys or alternatives.
+            const SchemaValue* source;      /// The SchemaValue the node was compiled from, used for error messages. nullptr for the root.
+            uint32_t discriminator = NoNode; /// Index in `discriminators` for an Either that picks its object alternative by a key, NoNode otherwise.
+            uint32_t table = NoNode;        /// Index in `tables` of the KeyTable of an object node, NoNode otherwise.
+        };
+
+        /**
+         * @struct Key
+         * @brief Struct representing a key of a compiled object.
+         */
+        struct Key {
+            std::string name;               /// The key.
+            uint32_t node;                  /// Index of the node that the value is validated against.
+        };
+
+        /**
+         * @struct Discriminator
+         * @brief Struct representing how an Either node picks the one object alternative an object is validated against.
+         * @note Set by Either::Discriminate, the alternative is picked by the value of the key. Otherwise Compile
+         *       looks for a key that every object alternative has, each with types no other one allows, and the
+         *       alternative is picked by the type of the value. That never changes the result, since every other
+         *       alternative would fail on that key.
+         */
+        struct Discriminator {
+            std::string key;                /// The key of the object whose value picks the alternative.
+            std::vector<Key> values;        /// Set by Either::Discriminate: the values of key, sorted, each with the alternative node it picks.
+            uint32_t byType[std::variant_size_v<parser_types::YamlValue>]; /// Otherwise: the alternative node picked by each type of the value of key, NoNode if none.
+
+            /**
+             * @brief Picks an alternative by the value of the key.
+             * @param value The value of the key.
+             * @return The alternative node, NoNode if the value picks none.
+             */
+            uint32_t Pick(const parser_types::YamlValue& value) const;
+        };
+
+        std::vector<Node> nodes;            /// All compiled nodes.
+        std::vector<Key> keys;              /// Keys of all objects, sorted by name within each object.
+        std::vector<uint32_t> alternatives; /// Node indices of the alternatives of all Either nodes.
+        std::vector<Discriminator> discriminators; /// Discriminators of the Either nodes that have one.
+        std::vector<KeyTable> tables;       /// KeyTables of the object nodes, each over the keys of its object in the order they are in `keys`.
+        uint32_t root = 0;                  /// Index of the root node.
+        uint64_t fingerprint = 0;           /// Hash of the nodes, keys and alternatives. Keys cached results, see Schema::SetCache.
+
+        std::variant<std::shared_ptr<ObjectImplementation>, std::shared_ptr<ArrayImplementation>> schema; /// Keeps the tree that `source` points into alive.
+
+        /**
+         * @brief Gets the bit that represents the type of a YamlValue in a typeMask.
+         * @param value The YamlValue.
+         * @return A mask with exactly one bit set.
+         */
+        static uint32_t TypeBit(const parser_types::YamlValue& value) { return 1u << value.index(); }
+
+        /**
+         * @brief Gets the bit that represents a parser type in a typeMask.
+         * @return A mask with the bit at the index of T in parser_types::YamlValue set.
+         */
+        template<typename T, size_t I = 0>
+        static constexpr uint32_t TypeBitOf() {
+            if constexpr (std::is_same_v<std::variant_alternative_t<I, parser_types::YamlValue>, T>)
+                return 1u << I;
+            else
+                return TypeBitOf<T, I + 1>();
+        }
+
+        /**
+         * @brief Finds a key of a compiled object.
+         * @param node The object node.
+         * @param key The key to look for.
+         * @return Pointer to the Key, nullptr if the object does not contain the key.
+         */
+        const Key* FindKey(const Node& node, std::string_view key) const;
+
+        /**
+         * @brief Picks the one alternative of an Either node that an object has to match.
+         * @param node The Either node. Must have a discriminator.
+         * @param object The object.
+         * @return The alternative node, or NoNode if the object has to be validated against each alternative in turn.
+         */
+        uint32_t Discriminate(const Node& node, const parser_types::Object& object) const;
+    };
+
+    /**
+     * @class ValidationMemo
+     * @brief Results of validating the containers of one Document, so that validating it again
+     *        only revisits the entries that changed since.
+     * @note Whoever replaces an entry of a container must report it with Changed, for the container
+     *       and every container around it, and Forget the containers that were replaced.
+     */
+    class ValidationMemo {
+    private:
+        friend class Schema;
+
+        /**
+         * @struct Entry
+         * @brief The result of validating a container against one node.
+         */
+        struct Entry {
+            uint32_t node;                                  /// Index of the node the container was validated against.
+            std::map<uint32_t, ValidationResult> failures;  /// The errors of the entries that do not validate, by index. The first one is the result.
+            std::vector<uint32_t> changed;                  /// Indices of the entries replaced since, to validate again.
+        };
+
+        std::shared_ptr<const CompiledSchema> compiled;                 /// The schema the results were validated against.
+        std::unordered_map<const void*, std::vector<Entry>> results;    /// The results of each Object or Array, per node it was validated against.
+
+    public:
+        /**
+         * @brief Marks an entry of a container as replaced.
+         * @param container The Object or Array.
+         * @param index Index of the entry, in insertion order.
+         */
+        void Changed(const void* container, uint32_t index) {
+            auto found = results.find(container);
+            if (found == results.end())
+                return;
+
+            for (Entry& entry : found->second) {
+                if (std::find(entry.changed.begin(), entry.changed.end(), index) == entry.changed.end())
+                    entry.changed.push_back(index);
+            }
+        }
+
+        /**
+         * @brief Drops the results of a container.
+         * @param container The Object or Array that is no longer part of the Document.
+         */
+        void Forget(const void* container) { results.erase(container); }
+
+        /**
+         * @brief Drops every result, eg. when the Document is replaced.
+         */
+        void Clear() { results.clear(); }
     };
 
 private:
+    /**
+     * @struct ErrorLocation
+     * @brief Non-owning reference to the parser Array index or parser Object key being validated.
+     *        Only converted into SchemaError information once a mismatch is actually found.
+     */
+    struct ErrorLocation {
+        const parser_types::Yaml* root = nullptr; /// The root handle that owns the Document being validated.
+        parser_types::Array* array = nullptr; /// The parser Array being validated, if any.
+        parser_types::Object* object = nullptr; /// The parser Object being validated, if any.
+        int index = 0; /// The index in the parser Array.
+        std::string_view key; /// The key in the parser Object.
+
+        ErrorLocation(const parser_types::Yaml& root, parser_types::Array* array, int index) : root(&root), array(array), index(index) {};
+        ErrorLocation(const parser_types::Yaml& root, parser_types::Object* object, std::string_view key) : root(&root), object(object), key(key) {};
+
+        /**
+         * @brief Makes a shared pointer to a node of the Document that keeps the whole Document alive.
+         * @param node Object or Array owned by the same Document as root.
+         * @return Shared pointer aliasing the ownership of root.
+         */
+        template<typename T>
+        std::shared_ptr<T> Share(T* node) const {
+            return std::visit([node](const auto& owner) { return std::shared_ptr<T>(owner, node); }, *root);
+        }
+
+        /**
+         * @brief Copies the referenced location into owned SchemaError information.
+         * @return ArrayError or ObjectError pointing at the location.
+         */
+        std::variant<SchemaError::ArrayError, SchemaError::ObjectError> ToInformation() const {
+            if (array != nullptr)
+                return SchemaError::ArrayError(Share(array), index);
+            return SchemaError::ObjectError(Share(object), std::string(key));
+        }
+    };
+
     /**
      * @brief Compares provided SchemaValue and YamlValue.
      * @param schemaValue SchemaValue to compare.
      * @param yamlValue YamlValue to compare.
-     * @param mismatch ValidationResult error to return when a TypeMismatch occurs. 
+     * @param location Where yamlValue is located, used when a TypeMismatch occurs.
      * @return A ValidationResult object containing a ValidationError with appropriate information.
      */
-    static Schema::ValidationResult ValidateCompare(SchemaValue schemaValue, YamlValue yamlValue, ValidationResult mismatch);
+    static Schema::ValidationResult ValidateCompare(const SchemaValue& schemaValue, const YamlValue& yamlValue, const ErrorLocation& location);
+
+    /**
+     * @brief Validates the outcome of a parse operation against the schema.
+     * @param result The ParserResult to validate.
+     * @return A ValidationResult object containing either a ValidationError or a ValidationSuccess object.
+     */
+    ValidationResult ValidateParserResult(const ParserResult& result);
+
+    /**
+     * @brief Validates the outcome of a parse operation against the schema and collects every error.
+     * @param result The ParserResult to validate.
+     * @param options The maximum number of errors and an optional sink that receives them as they are found.
+     * @return The errors in document order, a single ParserError if the parse failed.
+     */
+    ErrorList ValidateAllParserResult(const ParserResult& result, const CollectOptions& options);
+
+    std::shared_ptr<const CompiledSchema> compiled; /// The schema root compiled once at construction.
+    std::shared_ptr<ValidationCache> cache; /// Where results of files are looked up before parsing them, if anywhere.
+
+    /**
+     * @brief Appends the compiled form of a SchemaValue and everything below it.
+     * @param compiled The CompiledSchema to append to.
+     * @param value The SchemaValue to compile.
+     * @param source Pointer stored as the node source, nullptr for the root.
+     * @param seen Maps already compiled Array- and ObjectImplementations to their node, so shared sub-schemas are compiled once.
+     * @return Index of the compiled node.
+     */
+    static uint32_t CompileNode(CompiledSchema& compiled, const SchemaValue& value, const SchemaValue* source, std::unordered_map<const void*, uint32_t>& seen);
+
+    /**
+     * @struct ParallelContext
+     * @brief Where and how the compiled validation may split large containers across threads.
+     * @note Chunks of a split container stop early once a chunk before them has failed, since
+     *       only the error of the first failed chunk is reported. Nested splits also stop
+     *       when the chunk they belong to stops.
+     */
+    struct ParallelContext {
+        ThreadPool* pool;                                   /// The pool that runs the chunks.
+        size_t grainSize;                                   /// Containers with more entries than this are split into chunks of this many.
+        const std::atomic<size_t>* firstFailed = nullptr;   /// Index of the first failed chunk of the enclosing split, if inside one.
+        size_t chunk = 0;                                   /// Index of the current chunk of the enclosing split.
+        const ParallelContext* parent = nullptr;            /// The context of the chunk the enclosing split belongs to, if any.
+
+        /**
+         * @brief Checks whether the result of the current chunk can no longer be reported.
+         * @return True if a chunk before it, or before any chunk it is nested in, has failed.
+         */
+        bool IsCancelled() const {
+            for (const ParallelContext* context = this; context != nullptr && context->firstFailed != nullptr; context = context->parent) {
+                if (context->firstFailed->load(std::memory_order_relaxed) < context->chunk)
+                    return true;
+            }
+            return false;
+        }
+    };
+
+    /**
+     * @brief Validates count entries of a container in chunks of parallel.grainSize on parallel.pool.
+     * @param count Number of entries.
+     * @param parallel The context of the container.
+     * @param validateEntry Callable taking an entry index and the ParallelContext of its chunk, returning a ValidationResult.
+     * @return The error of the first entry that failed, as serial validation would, or a ValidationSuccess.
+     */
+    template<typename F>
+    static ValidationResult ValidateChunks(size_t count, const ParallelContext& parallel, F validateEntry);
+
+    /**
+     * @brief Compiled counterpart of ValidateCompare.
+     * @param compiled The CompiledSchema to validate against.
+     * @param node Index of the node to compare yamlValue to.
+     * @param yamlValue YamlValue to compare.
+     * @param location Where yamlValue is located, used when a TypeMismatch occurs.
+     * @param parallel Where large containers may be split, nullptr to validate serially.
+     * @param memo Where results of containers are looked up and remembered, if anywhere. Only used serially.
+     * @return A ValidationResult object containing either a ValidationError or a ValidationSuccess object.
+     */
+    static ValidationResult ValidateCompiledValue(const CompiledSchema& compiled, uint32_t node, const YamlValue& yamlValue, const ErrorLocation& location, const ParallelContext* parallel = nullptr, ValidationMemo* memo = nullptr);
+
+    /**
+     * @brief Compiled counterpart of Validate for a parser Object.
+     * @param compiled The CompiledSchema to validate against.
+     * @param node Index of an ObjectNode.
+     * @param root The root handle that owns the Document of object.
+     * @param object The parser Object to validate.
+     * @param parallel Where large containers may be split, nullptr to validate serially.
+     * @param memo Where results of containers are looked up and remembered, if anywhere. Only used serially.
+     * @return A ValidationResult object containing either a ValidationError or a ValidationSuccess object.
+     */
+    static ValidationResult ValidateCompiledObject(const CompiledSchema& compiled, uint32_t node, const parser_types::Yaml& root, parser_types::Object* object, const ParallelContext* parallel = nullptr, ValidationMemo* memo = nullptr);
+
+    /**
+     * @brief Compiled counterpart of Validate for a parser Array.
+     * @param compiled The CompiledSchema to validate against.
+     * @param node Index of an ArrayNode.
+     * @param root The root handle that owns the Document of array.
+     * @param array The parser Array to validate.
+     * @param parallel Where large containers may be split, nullptr to validate serially.
+     * @param memo Where results of containers are looked up and remembered, if anywhere. Only used serially.
+     * @return A ValidationResult object containing either a ValidationError or a ValidationSuccess object.
+     */
+    static ValidationResult ValidateCompiledArray(const CompiledSchema& compiled, uint32_t node, const parser_types::Yaml& root, parser_types::Array* array, const ParallelContext* parallel = nullptr, ValidationMemo* memo = nullptr);
+
+    /**
+     * @brief Validates the entries of a container in order, through a memo.
+     * @param memo The memo, nullptr to stop at the first entry that does not validate.
+     * @param container The Object or Array.
+     * @param node Index of the node it is validated against.
+     * @param size Number of entries.
+     * @param validate Callable returning the ValidationResult of the entry at an index.
+     * @return The error of the first entry that does not validate, if any. With a memo, only the entries
+     *         changed since the last time are validated, or every entry the first time.
+     */
+    template<typename F>
+    static ValidationResult Recall(ValidationMemo* memo, const void* container, uint32_t node, size_t size, F validate);
+
+    class StreamingValidator;
+
+    /**
+     * @struct ErrorCollector
+     * @brief Adds errors to an ErrorList until CollectOptions::maxErrors is reached.
+     */
+    struct ErrorCollector {
+        const CollectOptions& options;  /// The cap and sink.
+        ErrorList& list;                /// Receives the errors.
+
+        /**
+         * @brief Adds an error, or marks the list as truncated if it is full.
+         * @param error The error, a ValidationError.
+         * @return False once validation should stop.
+         */
+        bool Add(ValidationResult&& error);
+    };
+
+    /**
+     * @brief Collect-all counterpart of ValidateCompiledValue.
+     * @note Keeps going after an error inside objects and arrays. An Either still only reports
+     *       that none of its alternatives matched, not why each of them did not.
+     * @param compiled The CompiledSchema to validate against.
+     * @param node Index of the node to compare yamlValue to.
+     * @param yamlValue YamlValue to compare.
+     * @param location Where yamlValue is located, used when a TypeMismatch occurs.
+     * @param collector Receives the errors.
+     * @return False once validation should stop.
+     */
+    static bool CollectCompiledValue(const CompiledSchema& compiled, uint32_t node, const YamlValue& yamlValue, const ErrorLocation& location, ErrorCollector& collector);
+
+    /**
+     * @brief Collect-all counterpart of ValidateCompiledObject.
+     * @return False once validation should stop.
+     */
+    static bool CollectCompiledObject(const CompiledSchema& compiled, uint32_t node, const parser_types::Yaml& root, parser_types::Object* object, ErrorCollector& collector);
+
+    /**
+     * @brief Collect-all counterpart of ValidateCompiledArray.
+     * @return False once validation should stop.
+     */
+    static bool CollectCompiledArray(const CompiledSchema& compiled, uint32_t node, const parser_types::Yaml& root, parser_types::Array* array, ErrorCollector& collector);
+
+    /**
+     * @brief Parses a Yaml file and validates it against a compiled schema.
+     * @param path The file path to the input file.
+     * @param compiled The CompiledSchema which is used to validate.
+     * @param upstream Where the Document gets its memory from, the default resource if nullptr.
+     * @param cache Where the result is looked up before parsing and stored after validating, if anywhere.
+     * @param pool The pool that validates large arrays and objects in chunks, serial validation if nullptr.
+     * @param grainSize See Validate(const parser_types::Yaml&, const CompiledSchema&, ThreadPool&, size_t).
+     * @return A ValidationResult object containing either a ValidationError or a ValidationSuccess object.
+     */
+    static ValidationResult ValidateFile(const std::filesystem::path& path, const CompiledSchema& compiled, std::shared_ptr<std::pmr::memory_resource> upstream, ValidationCache* cache, ThreadPool* pool = nullptr, size_t grainSize = DefaultGrainSize);
+
+    /**
+     * @brief Serializes a ValidationResult for a ValidationCache.
+     * @param compiled The CompiledSchema the result was validated against.
+     * @param result The result.
+     * @note The expected value of a SchemaError is stored as the node it was compiled to.
+     *       Document values (errorRoot and got) are not stored.
+     * @return The bytes to store.
+     */
+    static std::string EncodeResult(const CompiledSchema& compiled, const ValidationResult& result);
+
+    /**
+     * @brief Restores a ValidationResult stored by EncodeResult.
+     * @param compiled The CompiledSchema the result was validated against.
+     * @param bytes The stored bytes.
+     * @return The result, std::nullopt if the bytes are not a result for this schema.
+     */
+    static std::optional<ValidationResult> DecodeResult(const CompiledSchema& compiled, std::string_view bytes);
 public:
 
+    /**
+     * @struct BatchOptions
+     * @brief Struct representing how ValidateFiles spreads its work.
+     */
+    struct BatchOptions {
+        unsigned workers = 0;           /// Number of worker threads, 0 for one per hardware thread. Never more than there are files.
+        bool perThreadArenas = true;    /// Whether each worker recycles Document memory through a pool of its own instead of the global heap.
+    };
+
     /**
      * @brief Creates a ValidationResult with provided ErrorType and information.
      * @param errorInformation Specific information about the error based on if the error occurs 
      *					       in an parser Array or parser Object.
      * @param errorType The type of error.
-     * @param message String containing message based on information and errorType.
      * @return A ValidationResult object containing a ValidationError with appropriate information.
      */
-    static ValidationResult GetValidationError(std::optional<std::variant<SchemaError::ArrayError, SchemaError::ObjectError>> errorInformation, ErrorType errorType, std::string message = "");
+    static ValidationResult GetValidationError(std::optional<std::variant<SchemaError::ArrayError, SchemaError::ObjectError>> errorInformation, ErrorType errorType);
 
     /**
-     * @brief Creates a ValidationResult with the UnexpectedValue errorType and information and a message based on parameters.
+     * @brief Creates a ValidationResult with the TypeMismatch errorType and information based on parameters.
      * @param errorInformation Specific information about the error based on if the error occurs
      *					       in an parser Array or parser Object.
      * @param expected The expected type of the value.
@@ -294,7 +864,7 @@ public:
     static ValidationResult GetValidationErrorMismatch(std::optional<std::variant<SchemaError::ArrayError, SchemaError::ObjectError>> errorInformation, SchemaValue expected, parser_types::YamlValue got);
 
     /**
-     * @brief Creates a ValidationResult with the UnexpectedValue errorType and information and a message based on parameters.
+     * @brief Creates a ValidationResult with the UnexpectedValue errorType and information based on parameters.
      * @param errorInformation Specific information about the error based on if the error occurs
      *					       in an parser Array or parser Object.
      * @param unexpected The unexpected YamlValue.
@@ -306,9 +876,31 @@ public:
      * @brief Constructor for Schema.
      * @param schema The root for the schema which is used to validate.
      */
-    Schema(std::variant<std::shared_ptr<ObjectImplementation>, std::shared_ptr<ArrayImplementation>> schema) : schema(schema) {
+    Schema(std::variant<std::shared_ptr<ObjectImplementation>, std::shared_ptr<ArrayImplementation>> schema) : schema(schema), compiled(Compile(schema)) {
     };
 
+    /**
+     * @brief Lowers a schema tree into a CompiledSchema.
+     * @param schema The root for the schema.
+     * @return The compiled schema. It keeps the tree alive and is safe to share between threads.
+     */
+    static std::shared_ptr<const CompiledSchema> Compile(std::variant<std::shared_ptr<ObjectImplementation>, std::shared_ptr<ArrayImplementation>> schema);
+
+    /**
+     * @brief Makes ValidateFromFile and ValidateFiles look results up in a persistent cache before parsing.
+     * @param cache The cache, nullptr to stop using one. May be shared by several schemas, threads and processes.
+     * @note Entries are keyed by a hash of the file contents and the fingerprint of the compiled schema,
+     *       so edited files and changed schemas miss. A result from the cache has the same shape as one from
+     *       ValidateStreaming: SchemaErrors have no errorRoot and no got value, since nothing was parsed.
+     */
+    void SetCache(std::shared_ptr<ValidationCache> cache) { this->cache = std::move(cache); }
+
+    /**
+     * @brief Gets the schema compiled at construction.
+     * @return The CompiledSchema used by the member Validate functions.
+     */
+    const CompiledSchema& GetCompiled() const { return *compiled; }
+
     /**
      * @brief Validates provided Yaml object based on provided schema.
      * @param yaml The parsed Yaml object.
@@ -317,10 +909,195 @@ public:
      */
     static ValidationResult Validate(parser_types::Yaml yaml, std::variant<std::shared_ptr<ObjectImplementation>, std::shared_ptr<ArrayImplementation>> schema);
 
+    /**
+     * @brief Validates provided Yaml object based on a compiled schema.
+     * @param yaml The parsed Yaml object.
+     * @param compiled The CompiledSchema which is used to validate.
+     * @return A ValidationResult object containing either a ValidationError or a ValidationSuccess object.
+     */
+    static ValidationResult Validate(const parser_types::Yaml& yaml, const CompiledSchema& compiled);
+
+    /**
+     * @brief Validates provided Yaml object based on a compiled schema, reusing the results of containers that did not change.
+     * @param yaml The parsed Yaml object.
+     * @param compiled The CompiledSchema which is used to validate.
+     * @param memo Results of earlier validations of the same Document against compiled. Updated with the new ones.
+     * @note Reports the same error as Validate(const parser_types::Yaml&, const CompiledSchema&).
+     * @return A ValidationResult object containing either a ValidationError or a ValidationSuccess object.
+     */
+    static ValidationResult Validate(const parser_types::Yaml& yaml, const CompiledSchema& compiled, ValidationMemo& memo);
+
+    static constexpr size_t DefaultGrainSize = 4096; /// Default for the number of entries a container needs before Validate splits it across threads.
+
+    /**
+     * @brief Validates provided Yaml object based on a compiled schema, splitting large arrays and objects across threads.
+     * @param yaml The parsed Yaml object.
+     * @param compiled The CompiledSchema which is used to validate.
+     * @param pool The pool that validates the chunks. The calling thread helps while it waits.
+     * @param grainSize Arrays and objects with at most this many entries are validated serially,
+     *                  larger ones are split into chunks of this many. 0 is taken as 1.
+     * @note Reports the same error as the serial Validate. Chunks after a failed one are cancelled.
+     * @return A ValidationResult object containing either a ValidationError or a ValidationSuccess object.
+     */
+    static ValidationResult Validate(const parser_types::Yaml& yaml, const CompiledSchema& compiled, ThreadPool& pool, size_t grainSize = DefaultGrainSize);
+
     /**
      * @brief Validates provided Yaml file.
+     * @note Looks the file up in the cache set with SetCache first, if any.
      * @return A ValidationResult object containing either a ValidationError or a ValidationSuccess object.
      */
     ValidationResult ValidateFromFile(const std::string& path);
+
+    /**
+     * @brief Validates provided Yaml file, splitting large arrays and objects across threads.
+     * @param path The file path to the input file.
+     * @param pool The pool that validates the chunks.
+     * @param grainSize See Validate(const parser_types::Yaml&, const CompiledSchema&, ThreadPool&, size_t).
+     * @note Looks the file up in the cache set with SetCache first, if any.
+     * @return A ValidationResult object containing either a ValidationError or a ValidationSuccess object.
+     */
+    ValidationResult ValidateFromFile(const std::string& path, ThreadPool& pool, size_t grainSize = DefaultGrainSize);
+
+    /**
+     * @brief Validates Yaml data that is already in memory.
+     * @param yaml The Yaml data itself, not a file path. The bytes are read in place
+     *             and only need to stay valid for the duration of the call.
+     * @return A ValidationResult object containing either a ValidationError or a ValidationSuccess object.
+     */
+    ValidationResult ValidateText(std::string_view yaml);
+
+    /**
+     * @brief Validates Yaml data that is already in memory, allocating from the given resource.
+     * @param yaml The Yaml data itself, not a file path. Only needs to stay valid for the duration of the call.
+     * @param resource Where the parser and the document allocate their memory, eg. a
+     *                 std::pmr::monotonic_buffer_resource per request or a pool per thread.
+     * @note A SchemaError refers to the document, so the resource must outlive the result.
+     *       The error itself is allocated from the default resource, like the schema.
+     * @return A ValidationResult object containing either a ValidationError or a ValidationSuccess object.
+     */
+    ValidationResult ValidateText(std::string_view yaml, std::pmr::memory_resource* resource);
+
+    /**
+     * @brief Validates the current state of a document that is being edited.
+     * @param document The document. Remembers the results of its containers, so validating it
+     *                 again after an edit only revisits the containers the edit changed.
+     * @return A ValidationResult object containing either a ValidationError or a ValidationSuccess object.
+     */
+    ValidationResult Validate(IncrementalDocument& document);
+
+    /**
+     * @brief Validates provided Yaml object and collects every error instead of stopping at the first.
+     * @param yaml The parsed Yaml object.
+     * @param compiled The CompiledSchema which is used to validate.
+     * @param options The maximum number of errors and an optional sink that receives them as they are found.
+     * @return The errors in document order, empty if the Yaml object matches the schema.
+     */
+    static ErrorList ValidateAll(const parser_types::Yaml& yaml, const CompiledSchema& compiled, const CollectOptions& options);
+
+    /**
+     * @brief Validates provided Yaml file and collects every error instead of stopping at the first.
+     * @param path The file path to the input file.
+     * @param options The maximum number of errors and an optional sink that receives them as they are found.
+     * @note A file that cannot be parsed gives a single ParserError.
+     * @return The errors in document order, empty if the file matches the schema.
+     */
+    ErrorList ValidateAllFromFile(const std::string& path, const CollectOptions& options);
+
+    /**
+     * @brief Validates provided Yaml file with the default CollectOptions and collects every error.
+     * @param path The file path to the input file.
+     * @return The errors in document order, empty if the file matches the schema.
+     */
+    ErrorList ValidateAllFromFile(const std::string& path) { return ValidateAllFromFile(path, CollectOptions()); }
+
+    /**
+     * @brief Validates Yaml data that is already in memory and collects every error instead of stopping at the first.
+     * @param yaml The Yaml data itself, not a file path.
+     * @param options The maximum number of errors and an optional sink that receives them as they are found.
+     * @note Data that cannot be parsed gives a single ParserError.
+     * @return The errors in document order, empty if the data matches the schema.
+     */
+    ErrorList ValidateAllText(std::string_view yaml, const CollectOptions& options);
+
+    /**
+     * @brief Validates Yaml data that is already in memory with the default CollectOptions and collects every error.
+     * @param yaml The Yaml data itself, not a file path.
+     * @return The errors in document order, empty if the data matches the schema.
+     */
+    ErrorList ValidateAllText(std::string_view yaml) { return ValidateAllText(yaml, CollectOptions()); }
+
+    /**
+     * @brief Validates Yaml data while it is parsed, without building a Document.
+     * @param parser The parser over the Yaml data.
+     * @param compiled The CompiledSchema which is used to validate.
+     * @note Memory use grows with the nesting depth of the data instead of its size,
+     *       and validation stops at the first value that cannot match the schema.
+     *       SchemaErrors have no errorRoot and no got value, since no Document exists
+     *       to point into, and a schema error is reported before any parser error later in the data.
+     *       The validator allocates from the memory resource of the parser.
+     * @return A ValidationResult object containing either a ValidationError or a ValidationSuccess object.
+     */
+    static ValidationResult ValidateStreaming(YamlParser& parser, const CompiledSchema& compiled);
+
+    /**
+     * @brief Validates provided Yaml file while it is parsed, without building a Document.
+     * @note See ValidateStreaming(YamlParser&, const CompiledSchema&).
+     * @return A ValidationResult object containing either a ValidationError or a ValidationSuccess object.
+     */
+    ValidationResult ValidateStreamingFromFile(const std::string& path);
+
+    /**
+     * @brief Validates Yaml data that is already in memory while it is parsed, without building a Document.
+     * @param yaml The Yaml data itself, not a file path.
+     * @note See ValidateStreaming(YamlParser&, const CompiledSchema&).
+     * @return A ValidationResult object containing either a ValidationError or a ValidationSuccess object.
+     */
+    ValidationResult ValidateStreamingText(std::string_view yaml);
+
+    /**
+     * @brief Validates Yaml data that is already in memory while it is parsed, allocating from the given resource.
+     * @param yaml The Yaml data itself, not a file path.
+     * @param resource Where the parser and the validator allocate their memory. Only needs to stay alive for the duration of the call.
+     * @note See ValidateStreaming(YamlParser&, const CompiledSchema&).
+     * @return A ValidationResult object containing either a ValidationError or a ValidationSuccess object.
+     */
+    ValidationResult ValidateStreamingText(std::string_view yaml, std::pmr::memory_resource* resource);
+
+    /**
+     * @brief Validates every document of a multi-document stream, one at a time.
+     * @param stream The stream. Read up to its end.
+     * @param sink Called with the result of each document, in stream order. A document is released
+     *             once the call returns, unless the sink keeps the errorRoot of its error.
+     * @return The number of documents that did not validate.
+     */
+    size_t ValidateDocuments(DocumentStream& stream, const std::function<void(const DocumentResult&)>& sink);
+
+    /**
+     * @brief Validates every document of a multi-document Yaml file, one at a time.
+     * @param path The file path to the input file.
+     * @param sink See ValidateDocuments(DocumentStream&, const std::function<void(const DocumentResult&)>&).
+     * @note A file that cannot be opened gives a single FileOpenError.
+     * @return The number of documents that did not validate.
+     */
+    size_t ValidateDocumentsFromFile(const std::string& path, const std::function<void(const DocumentResult&)>& sink);
+
+    /**
+     * @brief Validates many Yaml files in parallel on a work-stealing thread pool.
+     * @param paths The file paths of the input files.
+     * @param options How many workers to use and how they allocate.
+     * @note The compiled schema is shared read-only by every worker. Results that keep a
+     *       Document alive, through the errorRoot of a SchemaError, also keep the pool of
+     *       the worker that parsed it alive. Files are looked up in the cache set with SetCache first, if any.
+     * @return One ValidationResult per path, in the same order as paths.
+     */
+    std::vector<ValidationResult> ValidateFiles(std::span<const std::filesystem::path> paths, const BatchOptions& options) const;
+
+    /**
+     * @brief Validates many Yaml files in parallel with the default BatchOptions.
+     * @param paths The file paths of the input files.
+     * @note See ValidateFiles(std::span<const std::filesystem::path>, const BatchOptions&).
+     * @return One ValidationResult per path, in the same order as paths.
+     */
+    std::vector<ValidationResult> ValidateFiles(std::span<const std::filesystem::path> paths) const { return ValidateFiles(paths, BatchOptions()); }
 };
 
@@ -0,0 +1,174 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+
+/**
+ * @struct Statistics
+ * @brief Struct representing what parsing and validating one or more documents took: the input,
+ *        the values found in it, the memory the Documents used and the time spent in each phase.
+ * @note Only collected when YAML_VALIDATOR_STATISTICS is defined for the whole build, library and
+ *       users alike. Otherwise every counter stays 0, results carry no Statistics at all, and the
+ *       code that would update them compiles to nothing.
+ */
+struct Statistics {
+#ifdef YAML_VALIDATOR_STATISTICS
+    static constexpr bool Enabled = true;   /// Whether Statistics are collected.
+#else
+    static constexpr bool Enabled = false;  /// Whether Statistics are collected.
+#endif
+
+    uint64_t documents = 0;             /// Number of documents parsed, more than 1 once Statistics are added up.
+    uint64_t bytesRead = 0;             /// Input bytes the parser went through, up to an error if there was one.
+
+    uint64_t objects = 0;               /// Objects, block and flow.
+    uint64_t arrays = 0;                /// Arrays, block and flow.
+    uint64_t keys = 0;                  /// Keys of all objects.
+    uint64_t strings = 0;               /// Scalars that are strings, quoted or not.
+    uint64_t numbers = 0;               /// Scalars that are numbers.
+    uint64_t booleans = 0;              /// Scalars that are booleans.
+    uint64_t nulls = 0;                 /// Scalars that are null.
+    uint64_t timestamps = 0;            /// Scalars that are timestamps.
+    uint64_t maxDepth = 0;              /// Most objects and arrays open at the same time.
+
+    uint64_t classifierCalls = 0;       /// Calls to IsBoolean, IsNumber, IsNull and IsTimestamp to find the type of unquoted scalars.
+    uint64_t allocations = 0;           /// Blocks the arenas of the Documents took from their upstream resource.
+    uint64_t allocatedBytes = 0;        /// Bytes of those blocks.
+
+    uint64_t ioNanoseconds = 0;         /// Opening the input and mapping or reading it. Pages of a mapped file are only read while it is lexed.
+    uint64_t lexNanoseconds = 0;        /// Parsing, without the time spent in the event handler: scanning, unescaping and classifying.
+    uint64_t buildNanoseconds = 0;      /// Time spent in the event handler, building the Document.
+    uint64_t validateNanoseconds = 0;   /// Validating against the schema, including the event handler of streaming validation.
+
+    /**
+     * @brief Adds the Statistics of other documents, eg. to sum up a batch.
+     * @param other The Statistics to add.
+     * @return This object.
+     */
+    Statistics& operator+=(const Statistics& other) {
+        documents += other.documents;
+        bytesRead += other.bytesRead;
+        objects += other.objects;
+        arrays += other.arrays;
+        keys += other.keys;
+        strings += other.strings;
+        numbers += other.numbers;
+        booleans += other.booleans;
+        nulls += other.nulls;
+        timestamps += other.timestamps;
+        maxDepth = std::max(maxDepth, other.maxDepth);
+        classifierCalls += other.classifierCalls;
+        allocations += other.allocations;
+        allocatedBytes += other.allocatedBytes;
+        ioNanoseconds += other.ioNanoseconds;
+        lexNanoseconds += other.lexNanoseconds;
+        buildNanoseconds += other.buildNanoseconds;
+        validateNanoseconds += other.validateNanoseconds;
+        return *this;
+    }
+};
+
+/// Lets an empty member take no space. MSVC ignores the standard attribute and only honours its own.
+#ifdef _MSC_VER
+#define YAML_VALIDATOR_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define YAML_VALIDATOR_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
+/**
+ * @struct StatisticsSlot
+ * @brief Struct that holds the Statistics of a result or parser when they are collected, and is empty otherwise.
+ * @note Declare members of this type YAML_VALIDATOR_NO_UNIQUE_ADDRESS, so that they take no space when empty.
+ */
+template<bool Collected = Statistics::Enabled>
+struct StatisticsSlot {
+    const Statistics& Get() const {
+        static const Statistics none;
+        return none;
+    }
+
+    /**
+     * @brief Gets Statistics to update, which are discarded.
+     * @note Thread local, so that parsers on different threads never share them.
+     */
+    Statistics& Get() {
+        static thread_local Statistics discarded;
+        return discarded;
+    }
+
+    void Set(const Statistics&) {}
+};
+
+template<>
+struct StatisticsSlot<true> {
+    Statistics statistics;  /// The Statistics of the result.
+
+    const Statistics& Get() const { return statistics; }
+
+    Statistics& Get() { return statistics; }
+
+    void Set(const Statistics& value) { statistics = value; }
+};
+
+/**
+ * @class PhaseTimer
+ * @brief Class that adds the wall time of its scope to a counter of Statistics, when they are collected.
+ */
+class PhaseTimer {
+private:
+    uint64_t& counter;                              /// The counter, eg. Statistics::ioNanoseconds.
+    std::chrono::steady_clock::time_point start;    /// When the scope started.
+
+public:
+    explicit PhaseTimer(uint64_t& counter) : counter(counter) {
+        if constexpr (Statistics::Enabled)
+            start = std::chrono::steady_clock::now();
+    }
+
+    ~PhaseTimer() {
+        if constexpr (Statistics::Enabled)
+            counter += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+};
+
+/**
+ * @class CountingResource
+ * @brief Memory resource that passes every request on to another one, and counts the allocations.
+ * @note Not synchronized, like the arena of a Document that allocates from it.
+ */
+class CountingResource : public std::pmr::memory_resource {
+private:
+    std::shared_ptr<std::pmr::memory_resource> owner;   /// Keeps the upstream resource alive, nullptr for the default resource.
+    std::pmr::memory_resource* upstream;                /// Where the memory comes from.
+
+public:
+    uint64_t allocations = 0;   /// Number of allocations so far.
+    uint64_t bytes = 0;         /// Bytes allocated so far, not counting what was deallocated.
+
+    /**
+     * @brief Constructor for CountingResource.
+     * @param upstream Where the memory comes from, the default resource if nullptr.
+     */
+    explicit CountingResource(std::shared_ptr<std::pmr::memory_resource> upstream)
+        : owner(std::move(upstream)), upstream(owner != nullptr ? owner.get() : std::pmr::get_default_resource()) {}
+
+private:
+    void* do_allocate(size_t size, size_t alignment) override {
+        allocations++;
+        bytes += size;
+        return upstream->allocate(size, alignment);
+    }
+
+    void do_deallocate(void* memory, size_t size, size_t alignment) override {
+        upstream->deallocate(memory, size, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
@@ -0,0 +1,320 @@
+#include "Schema.h"
+#include "InputSource.h"
+
+#include <unordered_set>
+
+#define GetValidationSuccess ValidationResult(ValidationResult::ValidationSuccess())
+
+/**
+ * @class Schema::StreamingValidator
+ * @brief YamlEventHandler that checks every value against a CompiledSchema as soon as it is parsed.
+ * @note Each open container keeps the object or array nodes it may still match, its candidates.
+ *       A container usually has a single candidate. An Either with several object or array
+ *       alternatives gives it one candidate per alternative instead, and the value only fails
+ *       once all of them have failed, which is what validating each alternative in turn gives.
+ */
+class Schema::StreamingValidator : public YamlEventHandler {
+private:
+    static constexpr uint32_t NoNode = CompiledSchema::NoNode;
+
+    /**
+     * @struct Candidate
+     * @brief A node that an open container is validated against.
+     */
+    struct Candidate {
+        uint32_t node;      /// The ObjectNode or ArrayNode.
+        uint32_t parent;    /// Index of the candidate of the enclosing container this one was derived from.
+        uint32_t either;    /// The EitherNode that node is an alternative of, NoNode if none.
+        bool alive;         /// False once the container cannot match node anymore.
+    };
+
+    /**
+     * @struct Frame
+     * @brief An Object or Array that is still being parsed.
+     */
+    struct Frame {
+        bool isObject = false;                  /// Whether the container is an Object.
+        size_t firstCandidate = 0;              /// The candidates of the container start here and end where the next frame's start.
+        int index = 0;                          /// Index of the current item, for arrays.
+        std::pmr::string key;                   /// Key of the current value, for objects.
+        std::pmr::unordered_set<std::pmr::string> keys; /// Keys seen so far, for objects.
+
+        Frame(std::pmr::memory_resource* resource) : key(resource), keys(resource) {}
+    };
+
+    const CompiledSchema& compiled;
+    std::pmr::memory_resource* resource;        /// Where the frames and candidates are allocated.
+    std::pmr::vector<Candidate> candidates;     /// Candidates of all open containers, outermost first.
+    std::pmr::vector<Frame> frames;             /// Open containers are [0, depth). Frames past depth are kept for reuse.
+    size_t depth = 0;                           /// Number of open containers.
+    std::optional<ValidationResult> error;      /// Set once the document cannot match the schema anymore.
+
+    size_t EndOfCandidates(size_t frame) const {
+        return frame + 1 < depth ? frames[frame + 1].firstCandidate : candidates.size();
+    }
+
+    /**
+     * @brief Where the current value of a container is, as SchemaError information.
+     */
+    std::variant<SchemaError::ArrayError, SchemaError::ObjectError> Location(size_t frame) const {
+        if (frames[frame].isObject)
+            return SchemaError::ObjectError(nullptr, std::string(frames[frame].key));
+        return SchemaError::ArrayError(nullptr, frames[frame].index);
+    }
+
+    /**
+     * @brief Marks a candidate as failed, and its parent too once none of its siblings are left.
+     * @param frame The frame of the candidate.
+     * @param candidate Index of the candidate.
+     * @param errorFrame The frame whose current value caused the error.
+     * @param errorNode The node that the value did not match.
+     */
+    void Fail(size_t frame, size_t candidate, size_t errorFrame, uint32_t errorNode) {
+        if (!candidates[candidate].alive)
+            return;
+
+        candidates[candidate].alive = false;
+
+        if (frame == 0) {
+            error = ValidationResult(ValidationResult::ValidationError(SchemaError(Location(errorFrame), ErrorType::TypeMismatch, *compiled.nodes[errorNode].source)));
+            return;
+        }
+
+        const uint32_t parent = candidates[candidate].parent;
+
+        for (size_t i = frames[frame].firstCandidate; i < EndOfCandidates(frame); i++) {
+            if (candidates[i].alive && candidates[i].parent == parent)
+                return;
+        }
+
+        // As with the compiled Validate, running out of Either alternatives
+        // is reported for the Either itself rather than for the last alternative
+        if (candidates[candidate].either != NoNode)
+            Fail(frame - 1, parent, frame - 1, candidates[candidate].either);
+        else
+            Fail(frame - 1, parent, errorFrame, errorNode);
+    }
+
+    /**
+     * @brief Checks the current value of the innermost open container against all of its candidates.
+     * @param typeBit The TypeBit of the value.
+     * @param derive Whether the value is a container whose frame was just opened, to receive the derived candidates.
+     */
+    void Check(uint32_t typeBit, bool derive) {
+        const size_t frame = derive ? depth - 2 : depth - 1;
+        const size_t last = EndOfCandidates(frame);
+
+        for (size_t i = frames[frame].firstCandidate; i < last; i++) {
+            if (!candidates[i].alive)
+                continue;
+
+            const CompiledSchema::Node& parentNode = compiled.nodes[candidates[i].node];
+            uint32_t nodeIndex = parentNode.first;
+
+            if (frames[frame].isObject) {
+                // Keys that are not part of the schema are allowed
+                const CompiledSchema::Key* schemaKey = compiled.FindKey(parentNode, frames[frame].key);
+                if (schemaKey == nullptr)
+                    continue;
+
+                nodeIndex = schemaKey->node;
+            }
+
+            const CompiledSchema::Node& node = compiled.nodes[nodeIndex];
+
+            if ((node.typeMask & typeBit) == 0) {
+                Fail(frame, i, frame, nodeIndex);
+
+                if (error.has_value())
+                    return;
+                continue;
+            }
+
+            if (!derive || node.kind == CompiledSchema::ScalarNode)
+                continue;
+
+            if (node.kind != CompiledSchema::EitherNode) {
+                candidates.push_back({ nodeIndex, static_cast<uint32_t>(i), NoNode, true });
+                continue;
+            }
+
+            const size_t mark = candidates.size();
+
+            for (uint32_t a = node.first; a < node.first + node.count; a++) {
+                const uint32_t alternativeIndex = compiled.alternatives[a];
+                const CompiledSchema::Node& alternative = compiled.nodes[alternativeIndex];
+
+                if ((alternative.typeMask & typeBit) == 0)
+                    continue;
+
+                if (alternative.kind != CompiledSchema::ObjectNode && alternative.kind != CompiledSchema::ArrayNode) {
+                    // Matching the type is all this alternative checks, so the value passes
+                    candidates.resize(mark);
+                    break;
+                }
+
+                candidates.push_back({ alternativeIndex, static_cast<uint32_t>(i), nodeIndex, true });
+            }
+        }
+    }
+
+    /**
+     * @brief Fails the candidates of the innermost open object that a discriminator value does not pick, see Either::Discriminate.
+     * @param value The value of the current key.
+     * @note Only discriminators set by Either::Discriminate are checked. Those found by Compile pick by type,
+     *       and the candidates they would drop fail on the value anyway.
+     */
+    void Discriminate(const YamlValue& value) {
+        const size_t frame = depth - 1;
+
+        for (size_t i = frames[frame].firstCandidate; i < EndOfCandidates(frame); i++) {
+            if (!candidates[i].alive || candidates[i].either == NoNode)
+                continue;
+
+            const CompiledSchema::Node& either = compiled.nodes[candidates[i].either];
+            if (either.discriminator == NoNode)
+                continue;
+
+            const CompiledSchema::Discriminator& discriminator = compiled.discriminators[either.discriminator];
+            if (discriminator.values.empty() || discriminator.key != std::string_view(frames[frame].key))
+                continue;
+
+            const uint32_t picked = discriminator.Pick(value);
+
+            if (picked != NoNode && picked != candidates[i].node) {
+                Fail(frame, i, frame, candidates[i].either);
+
+                if (error.has_value())
+                    return;
+            }
+        }
+    }
+
+    bool Begin(bool isObject) {
+        const uint32_t typeBit = isObject ? CompiledSchema::TypeBitOf<parser_types::Object*>() : CompiledSchema::TypeBitOf<parser_types::Array*>();
+        const size_t firstCandidate = candidates.size();
+
+        if (frames.size() == depth)
+            frames.emplace_back(resource);
+
+        Frame& frame = frames[depth++];
+        frame.isObject = isObject;
+        frame.firstCandidate = firstCandidate;
+        frame.index = 0;
+        frame.key.clear();
+        frame.keys.clear();
+
+        if (depth == 1) {
+            const CompiledSchema::Node& root = compiled.nodes[compiled.root];
+
+            if ((root.typeMask & typeBit) == 0) {
+                error = GetValidationError(std::nullopt, ErrorType::UnexpectedValue);
+                return false;
+            }
+
+            candidates.push_back({ compiled.root, 0, NoNode, true });
+            return true;
+        }
+
+        Check(typeBit, true);
+        return !error.has_value();
+    }
+
+    bool End() {
+        candidates.resize(frames[--depth].firstCandidate);
+
+        if (depth > 0)
+            frames[depth - 1].index++;
+        return true;
+    }
+
+public:
+    StreamingValidator(const CompiledSchema& compiled, std::pmr::memory_resource* resource)
+        : compiled(compiled), resource(resource), candidates(resource), frames(resource) {}
+
+    bool BeginObject(SourcePosition) override { return Begin(true); }
+    bool EndObject(SourcePosition) override { return End(); }
+    bool BeginArray(SourcePosition) override { return Begin(false); }
+    bool EndArray(SourcePosition) override { return End(); }
+
+    bool Key(std::string_view key, SourcePosition position) override {
+        Frame& frame = frames[depth - 1];
+        frame.key.assign(key);
+
+        if (!frame.keys.insert(frame.key).second)
+            return YamlEventHandler::Fail(::ErrorType::DuplicateKeyError, position);
+        return true;
+    }
+
+    bool Scalar(const YamlValue& value, SourcePosition) override {
+        if (depth == 0) {
+            // Same as YamlParser::Parse() for a document that is not an Object or Array
+            error = ValidationResult(ValidationResult::ValidationError(ParserError(::ErrorType::InvalidDocumentStartError, 1, 1)));
+            return false;
+        }
+
+        Check(CompiledSchema::TypeBit(value), false);
+
+        if (frames[depth - 1].isObject && !error.has_value())
+            Discriminate(value);
+
+        frames[depth - 1].index++;
+        return !error.has_value();
+    }
+
+    /**
+     * @brief Gets the outcome once the parser is done.
+     * @return The first error, or a ValidationSuccess.
+     */
+    ValidationResult GetResult() const {
+        if (error.has_value())
+            return error.value();
+        return GetValidationSuccess;
+    }
+};
+
+Schema::ValidationResult Schema::ValidateStreaming(YamlParser& parser, const CompiledSchema& compiled) {
+    StreamingValidator validator(compiled, parser.GetMemoryResource());
+    std::optional<ParserError> parserError = parser.Parse(validator);
+
+    ValidationResult result = parserError.has_value()
+        ? ValidationResult(ValidationResult::ValidationError(parserError.value()))
+        : validator.GetResult();
+
+    if constexpr (Statistics::Enabled) {
+        // The handler is the validator here, so its time is validating rather than building
+        Statistics statistics = parser.GetStatistics();
+        statistics.validateNanoseconds += statistics.buildNanoseconds;
+        statistics.buildNanoseconds = 0;
+        result.AddStatistics(statistics);
+    }
+
+    return result;
+}
+
+Schema::ValidationResult Schema::ValidateStreamingFromFile(const std::string& path) {
+    uint64_t io = 0;
+    std::optional<InputSource> source;
+    {
+        PhaseTimer timer(io);
+        source = InputSource::FromFile(path);
+    }
+
+    if (!source.has_value())
+        return ValidationResult(ValidationResult::ValidationError(ParserError(::ErrorType::FileOpenError, 0, 0)));
+
+    // Nothing outlives the parse, so every scalar can view the input
+    YamlParser parser(source->View(), ViewInput);
+    parser.GetStatistics().ioNanoseconds += io;
+    return ValidateStreaming(parser, *compiled);
+}
+
+Schema::ValidationResult Schema::ValidateStreamingText(std::string_view yaml) {
+    YamlParser parser(yaml, ViewInput);
+    return ValidateStreaming(parser, *compiled);
+}
+
+Schema::ValidationResult Schema::ValidateStreamingText(std::string_view yaml, std::pmr::memory_resource* resource) {
+    YamlParser parser(yaml, ViewInput, resource);
+    return ValidateStreaming(parser, *compiled);
+}
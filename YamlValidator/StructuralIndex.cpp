@@ -0,0 +1,159 @@
+#include "StructuralIndex.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(__AVX2__)
+#define STRUCTURAL_INDEX_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STRUCTURAL_INDEX_SSE2
+#include <emmintrin.h>
+#endif
+
+// Must match what the loops in YamlParser::ParseValue and YamlParser::ParseObjectKey
+// treat as anything other than a plain character, see valueEndChars, invalidKeyChars
+// and invalidValueChars. Newlines are included so that the line count stays right.
+static constexpr std::string_view unquotedChars("\n !\"#%&'*,:<=>?@[\\]{|}");
+static constexpr std::string_view quotedChars("\n\"'\\");
+
+#if defined(STRUCTURAL_INDEX_AVX2)
+
+/**
+ * @struct NibbleTable
+ * @brief Lookup tables that test a byte for membership of a character set with two shuffles.
+ * @note Every distinct high nibble in the set gets its own bit. high[h] holds the bit of h,
+ *       low[l] the bits of every high nibble h for which (h << 4 | l) is in the set, so a byte
+ *       is in the set exactly when low[byte & 15] & high[byte >> 4] is not zero.
+ *       Works for sets with up to 8 distinct high nibbles.
+ */
+struct NibbleTable {
+    uint8_t low[16];
+    uint8_t high[16];
+};
+
+static constexpr NibbleTable MakeNibbleTable(std::string_view chars) {
+    NibbleTable table{};
+    uint8_t nextBit = 1;
+
+    for (char c : chars) {
+        const uint8_t high = static_cast<uint8_t>(c) >> 4;
+        const uint8_t low = static_cast<uint8_t>(c) & 0x0F;
+
+        if (table.high[high] == 0) {
+            table.high[high] = nextBit;
+            nextBit <<= 1;
+        }
+        table.low[low] |= table.high[high];
+    }
+    return table;
+}
+
+static constexpr NibbleTable unquotedTable = MakeNibbleTable(unquotedChars);
+static constexpr NibbleTable quotedTable = MakeNibbleTable(quotedChars);
+
+static uint32_t Match(__m256i chunk, const NibbleTable& table) {
+    const __m256i low = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table.low)));
+    const __m256i high = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table.high)));
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+
+    // Bytes >= 0x80 have a high nibble without a bit, so they never match
+    const __m256i lowBits = _mm256_shuffle_epi8(low, _mm256_and_si256(chunk, nibble));
+    const __m256i highBits = _mm256_shuffle_epi8(high, _mm256_and_si256(_mm256_srli_epi16(chunk, 4), nibble));
+    const __m256i outside = _mm256_cmpeq_epi8(_mm256_and_si256(lowBits, highBits), _mm256_setzero_si256());
+
+    return ~static_cast<uint32_t>(_mm256_movemask_epi8(outside));
+}
+
+static void ClassifyBlock(const char* bytes, uint64_t& unquoted, uint64_t& quoted) {
+    const __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes));
+    const __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + 32));
+
+    unquoted = Match(first, unquotedTable) | static_cast<uint64_t>(Match(second, unquotedTable)) << 32;
+    quoted = Match(first, quotedTable) | static_cast<uint64_t>(Match(second, quotedTable)) << 32;
+}
+
+#elif defined(STRUCTURAL_INDEX_SSE2)
+
+static __m128i Equal(__m128i chunk, char c) {
+    return _mm_cmpeq_epi8(chunk, _mm_set1_epi8(c));
+}
+
+// Bytes in [lo, hi]. Subtracting lo maps the range to [0, hi - lo] as unsigned bytes,
+// flipping the sign bit on top of that lets the signed compare test for it.
+static __m128i InRange(__m128i chunk, char lo, char hi) {
+    const __m128i shifted = _mm_sub_epi8(chunk, _mm_set1_epi8(static_cast<char>(lo + 0x80)));
+    return _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(hi - lo + 1 - 0x80)));
+}
+
+// SSE2 has no byte shuffle to look the characters up with, so unquotedChars
+// is tested for as the few ranges of adjacent characters that it consists of
+static uint32_t MatchUnquoted(__m128i chunk) {
+    __m128i matches = _mm_or_si128(Equal(chunk, '\n'), InRange(chunk, ' ', '#'));
+    matches = _mm_or_si128(matches, InRange(chunk, '%', '\''));
+    matches = _mm_or_si128(matches, _mm_or_si128(Equal(chunk, '*'), Equal(chunk, ',')));
+    matches = _mm_or_si128(matches, _mm_or_si128(Equal(chunk, ':'), InRange(chunk, '<', '@')));
+    matches = _mm_or_si128(matches, _mm_or_si128(InRange(chunk, '[', ']'), InRange(chunk, '{', '}')));
+    return static_cast<uint32_t>(_mm_movemask_epi8(matches));
+}
+
+static uint32_t MatchQuoted(__m128i chunk) {
+    __m128i matches = _mm_or_si128(Equal(chunk, '\n'), Equal(chunk, '"'));
+    matches = _mm_or_si128(matches, _mm_or_si128(Equal(chunk, '\''), Equal(chunk, '\\')));
+    return static_cast<uint32_t>(_mm_movemask_epi8(matches));
+}
+
+static void ClassifyBlock(const char* bytes, uint64_t& unquoted, uint64_t& quoted) {
+    unquoted = 0;
+    quoted = 0;
+
+    for (size_t i = 0; i < StructuralIndex::BlockSize; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+
+        unquoted |= static_cast<uint64_t>(MatchUnquoted(chunk)) << i;
+        quoted |= static_cast<uint64_t>(MatchQuoted(chunk)) << i;
+    }
+}
+
+#else
+
+/// Bit 0 is set for the Unquoted set, bit 1 for the Quoted set.
+static constexpr std::array<uint8_t, 256> MakeCharacterTable() {
+    std::array<uint8_t, 256> table{};
+
+    for (char c : unquotedChars)
+        table[static_cast<uint8_t>(c)] |= 1;
+    for (char c : quotedChars)
+        table[static_cast<uint8_t>(c)] |= 2;
+    return table;
+}
+
+static constexpr std::array<uint8_t, 256> characterTable = MakeCharacterTable();
+
+static void ClassifyBlock(const char* bytes, uint64_t& unquoted, uint64_t& quoted) {
+    unquoted = 0;
+    quoted = 0;
+
+    for (size_t i = 0; i < StructuralIndex::BlockSize; i++) {
+        const uint8_t classes = characterTable[static_cast<uint8_t>(bytes[i])];
+
+        unquoted |= static_cast<uint64_t>(classes & 1) << i;
+        quoted |= static_cast<uint64_t>(classes >> 1) << i;
+    }
+}
+
+#endif
+
+void StructuralIndex::Classify(const char* start) {
+    block = start;
+
+    if (end - start >= static_cast<ptrdiff_t>(BlockSize)) {
+        ClassifyBlock(start, unquoted, quoted);
+        return;
+    }
+
+    // The last block is padded with '\0', which is in neither set
+    char padded[BlockSize] = {};
+    std::memcpy(padded, start, end - start);
+    ClassifyBlock(padded, unquoted, quoted);
+}
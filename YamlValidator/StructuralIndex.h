@@ -0,0 +1,73 @@
+#pragma once
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include <bit>
+
+/**
+ * @class StructuralIndex
+ * @brief Class that finds the next character the parser has to look at, so that the
+ *        characters in between can be taken as a whole instead of one at a time.
+ * @note The input is classified in blocks of 64 bytes into one bitmap per character set,
+ *       with one bit per byte. Blocks are classified with AVX2 when compiled for it
+ *       (-mavx2, /arch:AVX2), with SSE2 on any other x86-64 target, and one byte at a
+ *       time elsewhere. Only the block at the cursor is kept, so the index needs no
+ *       memory beyond the object itself, however large the input is.
+ */
+class StructuralIndex {
+public:
+    static constexpr size_t BlockSize = 64; /// Number of bytes covered by each bitmap.
+
+    /**
+     * @enum CharacterSet
+     * @brief Enum representing which characters end a run of plain characters.
+     */
+    enum CharacterSet {
+        Unquoted,   /// Characters that end or change an unquoted key or scalar: newline, space, `,:[]{}`, quotes, `\` and the YAML indicators `#&*!|<>=%@?`.
+        Quoted,     /// Characters that end or change a quoted key or scalar: newline, quotes and `\`.
+    };
+
+private:
+    const char* begin;              /// First byte of the input.
+    const char* end;                /// One past the last byte of the input.
+
+    const char* block = nullptr;    /// First byte of the classified block, nullptr before the first one.
+    uint64_t unquoted = 0;          /// Bit i is set if block[i] is in the Unquoted set.
+    uint64_t quoted = 0;            /// Bit i is set if block[i] is in the Quoted set.
+
+    /**
+     * @brief Fills the bitmaps for the 64 bytes starting at start. Bytes past the end of input are never set.
+     * @param start The first byte of the block, a multiple of BlockSize from the beginning of the input.
+     */
+    void Classify(const char* start);
+
+public:
+    /**
+     * @brief Constructor for StructuralIndex.
+     * @param input The bytes to index. Must stay valid for the lifetime of the index.
+     */
+    StructuralIndex(std::string_view input) : begin(input.data()), end(input.data() + input.size()) {}
+
+    /**
+     * @brief Finds the first character at or after from that is in the given set.
+     * @param from Where to start looking, between the beginning and the end of the input.
+     * @param set The characters to look for.
+     * @return Pointer to the character, or the end of the input if there is none.
+     */
+    const char* Next(const char* from, CharacterSet set) {
+        while (from < end) {
+            const size_t offset = static_cast<size_t>(from - begin);
+            const char* start = begin + (offset & ~(BlockSize - 1));
+
+            if (start != block)
+                Classify(start);
+
+            const uint64_t bits = (set == Unquoted ? unquoted : quoted) >> (offset & (BlockSize - 1));
+            if (bits != 0)
+                return from + std::countr_zero(bits);
+
+            from = start + BlockSize;
+        }
+        return end;
+    }
+};
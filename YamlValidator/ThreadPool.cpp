@@ -0,0 +1,130 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <utility>
+
+/// The pool the calling thread is a worker of, if any.
+static thread_local const ThreadPool* currentPool = nullptr;
+
+/// Index of the calling thread in currentPool.
+static thread_local unsigned currentIndex = 0;
+
+ThreadPool::ThreadPool(unsigned workers) {
+    if (workers == 0)
+        workers = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned i = 0; i <= workers; i++)
+        queues.push_back(std::make_unique<Queue>());
+
+    threads.reserve(workers);
+    for (unsigned i = 0; i < workers; i++)
+        threads.emplace_back([this, i] { WorkerLoop(i); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+unsigned ThreadPool::CurrentWorker() const {
+    return currentPool == this ? currentIndex : WorkerCount();
+}
+
+void ThreadPool::Push(Task task) {
+    Queue& queue = *queues[CurrentWorker()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    queued++;
+
+    // Taking the lock orders the notification after a worker that is about to sleep has checked queued
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    wake.notify_one();
+}
+
+bool ThreadPool::RunOne(size_t self) {
+    Task task;
+
+    // Newest task of the own queue first, it is the most likely to still be in cache
+    {
+        Queue& own = *queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+        }
+    }
+
+    // Otherwise the oldest task of another queue, which is usually the largest
+    for (size_t i = 1; !task && i < queues.size(); i++) {
+        Queue& victim = *queues[(self + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+        }
+    }
+
+    if (!task)
+        return false;
+
+    queued--;
+    task();
+    return true;
+}
+
+void ThreadPool::WorkerLoop(size_t index) {
+    currentPool = this;
+    currentIndex = static_cast<unsigned>(index);
+
+    while (true) {
+        if (RunOne(index))
+            continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping || queued > 0; });
+
+        if (stopping)
+            return;
+    }
+}
+
+ThreadPool::TaskGroup::~TaskGroup() {
+    // Tasks refer to the group, so it must outlive them even if Wait was never called
+    while (pending > 0) {
+        if (!pool.RunOne(pool.CurrentWorker()))
+            std::this_thread::yield();
+    }
+}
+
+void ThreadPool::TaskGroup::Run(Task task) {
+    pending++;
+
+    pool.Push([this, task = std::move(task)] {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error)
+                error = std::current_exception();
+        }
+        pending--;
+    });
+}
+
+void ThreadPool::TaskGroup::Wait() {
+    while (pending > 0) {
+        if (!pool.RunOne(pool.CurrentWorker()))
+            std::this_thread::yield();
+    }
+
+    if (error)
+        std::rethrow_exception(std::exchange(error, nullptr));
+}
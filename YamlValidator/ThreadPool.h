@@ -0,0 +1,119 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Work-stealing pool of worker threads.
+ * @note Every worker has its own queue. Tasks submitted by a worker go to the back of its own
+ *       queue and it takes them back from there, newest first. A worker without tasks steals
+ *       the oldest task of another queue, so big chunks of work spread out and small ones stay
+ *       local. Tasks submitted from any other thread go to one shared queue.
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @class TaskGroup
+     * @brief Set of tasks that can be waited for together, for fork-join parallelism.
+     * @note Waiting runs queued tasks instead of blocking, so a task may fork and wait for
+     *       a group of its own without tying up a worker.
+     */
+    class TaskGroup {
+    private:
+        ThreadPool& pool;                       /// The pool that runs the tasks.
+        std::atomic<size_t> pending = 0;        /// Number of tasks that have not finished yet.
+        std::mutex errorMutex;                  /// Guards error.
+        std::exception_ptr error;               /// The first exception thrown by a task.
+
+    public:
+        TaskGroup(ThreadPool& pool) : pool(pool) {}
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        ~TaskGroup();
+
+        /**
+         * @brief Queues a task on the pool as part of this group.
+         * @param task The task to run.
+         */
+        void Run(Task task);
+
+        /**
+         * @brief Runs queued tasks until every task of the group has finished.
+         * @throws The first exception thrown by a task of the group, if any.
+         */
+        void Wait();
+    };
+
+private:
+    /**
+     * @struct Queue
+     * @brief Tasks waiting to be run, owned by one worker or shared by every other thread.
+     */
+    struct Queue {
+        std::mutex mutex;                       /// Guards tasks.
+        std::deque<Task> tasks;                 /// The owner takes from the back, thieves from the front.
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues; /// One per worker, followed by the shared queue.
+    std::vector<std::thread> threads;           /// The workers.
+
+    std::atomic<size_t> queued = 0;             /// Number of tasks in all queues.
+    std::mutex sleepMutex;                      /// Guards stopping and sleeping on wake.
+    std::condition_variable wake;               /// Wakes sleeping workers when tasks are queued or the pool stops.
+    bool stopping = false;                      /// Set when the pool is destroyed.
+
+    /**
+     * @brief Queues a task on the queue of the calling thread.
+     * @param task The task to run.
+     */
+    void Push(Task task);
+
+    /**
+     * @brief Runs one queued task, if there is any.
+     * @param self Index of the queue that belongs to the calling thread.
+     * @return True if a task was run.
+     */
+    bool RunOne(size_t self);
+
+    /**
+     * @brief Runs tasks until the pool is destroyed.
+     * @param index Index of the worker.
+     */
+    void WorkerLoop(size_t index);
+
+public:
+    /**
+     * @brief Constructor for ThreadPool.
+     * @param workers Number of worker threads, 0 for one per hardware thread.
+     */
+    explicit ThreadPool(unsigned workers = 0);
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Stops and joins the workers. Tasks still queued are not run.
+     */
+    ~ThreadPool();
+
+    /**
+     * @brief Gets the number of worker threads.
+     */
+    unsigned WorkerCount() const { return static_cast<unsigned>(threads.size()); }
+
+    /**
+     * @brief Gets the index of the calling thread in this pool.
+     * @return The worker index, or WorkerCount() for any thread that is not a worker of this pool.
+     */
+    unsigned CurrentWorker() const;
+};
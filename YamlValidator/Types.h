@@ -1,26 +1,31 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <variant>
 #include <unordered_map>
 #include <vector>
 #include <optional>
 #include <memory>
-#include <map>
+#include <memory_resource>
+#include <cstdint>
 
 namespace parser_types {
 
+    // Scalars view characters owned by the Document they belong to, the input
+    // it retains, or static storage when created from a string literal.
+
     struct String {
-        std::string value;
-        String(const std::string& value) : value(value) {}
+        std::string_view value;
+        String(std::string_view value) : value(value) {}
         String(const char value[]) : value(value) {}
 
         bool operator<(const String& other) const { return value < other.value; };
     };
 
     struct Number {
-        std::string value;
-        Number(const std::string& value) : value(value) {}
+        std::string_view value;
+        Number(std::string_view value) : value(value) {}
         Number(const char value[]) : value(value) {}
     };
 
@@ -30,8 +35,8 @@ namespace parser_types {
     };
 
     struct Timestamp {
-        std::string value;
-        Timestamp(const std::string& value) : value(value) {}
+        std::string_view value;
+        Timestamp(std::string_view value) : value(value) {}
         Timestamp(const char value[]) : value(value) {}
     };
 
@@ -39,61 +44,147 @@ namespace parser_types {
 
     class Object;
     class Array;
+    class Document;
+
+    // Containers are owned by their Document, values only point to them
+    using YamlValue = std::variant<String, Number, Boolean, Timestamp, Null, Object*, Array*>;
 
-    using YamlValue = std::variant<String, Number, Boolean, Timestamp, Null, std::shared_ptr<Object>, std::shared_ptr<Array>>;
+    // The root keeps the whole Document alive
     using Yaml = std::variant<std::shared_ptr<Object>, std::shared_ptr<Array>>;
 
+    // Keys keep the order they were parsed in. Small objects are searched
+    // linearly, larger ones also get an open-addressing index over the keys.
     class Object {
+    public:
+        static constexpr size_t IndexThreshold = 16;
+
     private:
-        std::map<std::string, YamlValue> map;
+        static constexpr size_t NotFound = static_cast<size_t>(-1);
+
+        std::pmr::vector<std::pair<std::string_view, YamlValue>> entries;
+        std::pmr::vector<uint32_t> slots; // Entry index + 1, 0 for an empty slot. Empty until IndexThreshold is exceeded.
+
+        std::string_view CopyKey(std::string_view key) {
+            char* data = static_cast<char*>(entries.get_allocator().resource()->allocate(key.size(), 1));
+            key.copy(data, key.size());
+            return std::string_view(data, key.size());
+        }
+
+        size_t Find(std::string_view key) const {
+            if (slots.empty()) {
+                for (size_t i = 0; i < entries.size(); i++) {
+                    if (entries[i].first == key)
+                        return i;
+                }
+                return NotFound;
+            }
+
+            const size_t mask = slots.size() - 1;
+            for (size_t slot = std::hash<std::string_view>()(key) & mask; slots[slot] != 0; slot = (slot + 1) & mask) {
+                if (entries[slots[slot] - 1].first == key)
+                    return slots[slot] - 1;
+            }
+            return NotFound;
+        }
+
+        void IndexEntry(size_t index) {
+            const size_t mask = slots.size() - 1;
+            size_t slot = std::hash<std::string_view>()(entries[index].first) & mask;
+            while (slots[slot] != 0)
+                slot = (slot + 1) & mask;
+            slots[slot] = static_cast<uint32_t>(index + 1);
+        }
+
+        // slotCount must be a power of two, kept at least twice the number of entries
+        void Rebuild(size_t slotCount) {
+            slots.assign(slotCount, 0);
+            for (size_t i = 0; i < entries.size(); i++)
+                IndexEntry(i);
+        }
+
+        void Append(std::string_view key, const YamlValue& value) {
+            entries.emplace_back(key, value);
+
+            if (!slots.empty()) {
+                if (entries.size() * 2 > slots.size())
+                    Rebuild(slots.size() * 2);
+                else
+                    IndexEntry(entries.size() - 1);
+            }
+            else if (entries.size() > IndexThreshold) {
+                Rebuild(IndexThreshold * 4);
+            }
+        }
 
     public:
-        Object() {}
+        Object(std::pmr::memory_resource* resource) : entries(resource), slots(resource) {}
+
+        void Set(std::string_view key, const YamlValue& value) {
+            if (Find(key) == NotFound)
+                Append(CopyKey(key), value);
+        }
+
+        void Set(std::pair<std::string_view, YamlValue> kv) {
+            Set(kv.first, kv.second);
+        }
+
+        // Like Set, but stores the key without copying it. The characters
+        // must already be owned by the Document, eg. from Document::CopyString.
+        // Returns false, and keeps the existing value, if the key is already present.
+        bool Emplace(std::string_view key, const YamlValue& value) {
+            if (Find(key) != NotFound)
+                return false;
 
-        void Set(const std::string& key, YamlValue& value) {
-            map.emplace(key, std::move(value));
+            Append(key, value);
+            return true;
         }
 
-        void Set(std::pair<std::string, YamlValue> kv) {
-            map.emplace(kv.first, std::move(kv.second));
+        // Replaces the value of the entry at index, in insertion order, keeping its key
+        void Replace(size_t index, const YamlValue& value) {
+            entries[index].second = value;
         }
 
-        std::optional<YamlValue> Get(const std::string& key) const {
-            auto it = map.find(key);
-            if (it != map.end()) {
-                return it->second;
+        std::optional<YamlValue> Get(std::string_view key) const {
+            size_t index = Find(key);
+            if (index != NotFound) {
+                return entries[index].second;
             }
             return std::nullopt;
         }
 
         std::vector<std::string> ExtractKeys() const {
             std::vector<std::string> keys;
-            keys.reserve(map.size());
-            for (const auto& pair : map) {
-                keys.push_back(pair.first);
+            keys.reserve(entries.size());
+            for (const auto& pair : entries) {
+                keys.push_back(std::string(pair.first));
             }
             return keys;
         }
 
-        bool ContainsKey(const std::string& key) const {
-            return map.find(key) != map.end();
+        bool ContainsKey(std::string_view key) const {
+            return Find(key) != NotFound;
         }
 
         size_t Size() const {
-            return map.size();
+            return entries.size();
         }
 
         void Clear() {
-            map.clear();
+            entries.clear();
+            slots.clear();
         }
+
+        // Iterates the key-value pairs in insertion order without copying them
+        auto begin() const { return entries.begin(); }
+        auto end() const { return entries.end(); }
     };
 
     class Array {
     private:
-        std::vector<YamlValue> values;
+        std::pmr::vector<YamlValue> values;
 
     public:
-        Array() {}
+        Array(std::pmr::memory_resource* resource) : values(resource) {}
 
         void PushBack(const YamlValue& value) {
             values.push_back(value);
@@ -103,6 +194,10 @@ namespace parser_types {
             values.pop_back();
         }
 
+        void Replace(size_t index, const YamlValue& value) {
+            values[index] = value;
+        }
+
         std::optional<YamlValue> Get(const size_t index) const {
             if (index < values.size()) {
                 return std::optional<YamlValue>(values[index]);
@@ -110,7 +205,7 @@ namespace parser_types {
             return std::nullopt;
         }
 
-        YamlValue operator[](const size_t index) const {
+        const YamlValue& operator[](const size_t index) const {
             return values[index];
         }
 
@@ -125,5 +220,85 @@ namespace parser_types {
         void Clear() {
             values.clear();
         }
+
+        // Iterates the values without copying them
+        auto begin() const { return values.begin(); }
+        auto end() const { return values.end(); }
+    };
+
+    // Owns every Object, Array, key and scalar of a parsed Yaml document in a few
+    // large blocks. Nothing is freed individually, the arena is released at once
+    // when the last Yaml handle to the document goes away.
+    class Document : public std::enable_shared_from_this<Document> {
+    private:
+        std::shared_ptr<std::pmr::memory_resource> upstream; // Declared before the arena, which returns its blocks to it
+        std::pmr::monotonic_buffer_resource arena;
+        std::shared_ptr<const void> input;
+
+        struct Private {};
+
+    public:
+        static constexpr size_t InitialBlockSize = 1 << 14;
+
+        Document(Private, std::shared_ptr<std::pmr::memory_resource> upstream)
+            : upstream(std::move(upstream)), arena(InitialBlockSize, this->upstream ? this->upstream.get() : std::pmr::get_default_resource()) {}
+
+        Document(const Document&) = delete;
+        Document& operator=(const Document&) = delete;
+
+        // The arena takes its blocks from upstream, eg. a pool that recycles them between
+        // documents, or from the default resource if none is given. The document keeps it alive.
+        static std::shared_ptr<Document> Create(std::shared_ptr<std::pmr::memory_resource> upstream = nullptr) {
+            return std::make_shared<Document>(Private(), std::move(upstream));
+        }
+
+        // As above, but the caller keeps upstream alive for as long as the document, eg. a
+        // per-request buffer. The document itself is then allocated from upstream as well.
+        static std::shared_ptr<Document> Create(std::pmr::memory_resource* upstream) {
+            if (upstream == nullptr)
+                upstream = std::pmr::get_default_resource();
+
+            // Aliasing constructor with no owner, so the document does not try to free upstream
+            return Create(std::shared_ptr<std::pmr::memory_resource>(std::shared_ptr<void>(), upstream), upstream);
+        }
+
+        // As above, but the document itself is allocated from storage, eg. the resource that
+        // upstream passes its requests on to. The caller keeps storage alive for as long as the document.
+        static std::shared_ptr<Document> Create(std::shared_ptr<std::pmr::memory_resource> upstream, std::pmr::memory_resource* storage) {
+            return std::allocate_shared<Document>(std::pmr::polymorphic_allocator<Document>(storage), Private(), std::move(upstream));
+        }
+
+        std::pmr::memory_resource* Resource() {
+            return &arena;
+        }
+
+        // Objects and Arrays only hold arena memory, so they are never destroyed
+        Object* NewObject() {
+            return new (arena.allocate(sizeof(Object), alignof(Object))) Object(&arena);
+        }
+
+        Array* NewArray() {
+            return new (arena.allocate(sizeof(Array), alignof(Array))) Array(&arena);
+        }
+
+        std::string_view CopyString(std::string_view value) {
+            if (value.empty())
+                return std::string_view();
+
+            char* data = static_cast<char*>(arena.allocate(value.size(), 1));
+            value.copy(data, value.size());
+            return std::string_view(data, value.size());
+        }
+
+        // Keeps the owner of the parsed bytes alive, so scalars can view them in place
+        void Retain(std::shared_ptr<const void> owner) {
+            input = std::move(owner);
+        }
+
+        // Makes a root handle that shares ownership of the whole document
+        template<typename T>
+        std::shared_ptr<T> Share(T* node) {
+            return std::shared_ptr<T>(shared_from_this(), node);
+        }
     };
-};
\ No newline at end of file
+};
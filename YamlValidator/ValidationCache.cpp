@@ -0,0 +1,302 @@
+#include "ValidationCache.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <vector>
+
+static constexpr char entryMagic[4] = { 'Y', 'V', 'C', '1' };       /// Start of every entry, changes with the entry layout.
+static constexpr size_t headerSize = sizeof(entryMagic) + 4 * sizeof(uint64_t); /// Magic, the three Key fields and the value length.
+static constexpr uint64_t maxEntrySize = 1 << 24;                   /// Larger files in the directory are not entries.
+static constexpr const char* entryExtension = ".entry";
+static constexpr const char* temporaryPrefix = ".tmp-";
+
+/// Temporary files older than this were left behind by a process that died while storing.
+static constexpr std::chrono::minutes staleTemporaryAge(10);
+
+namespace xxh64 {
+
+    constexpr uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+    constexpr uint64_t Prime3 = 0x165667B19E3779F9ull;
+    constexpr uint64_t Prime4 = 0x85EBCA77C2B2AE63ull;
+    constexpr uint64_t Prime5 = 0x27D4EB2F165667C5ull;
+
+    static uint64_t Read64(const char* p) {
+        uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    static uint32_t Read32(const char* p) {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    static uint64_t Round(uint64_t accumulator, uint64_t input) {
+        accumulator += input * Prime2;
+        accumulator = std::rotl(accumulator, 31);
+        return accumulator * Prime1;
+    }
+
+    static uint64_t Merge(uint64_t hash, uint64_t accumulator) {
+        hash ^= Round(0, accumulator);
+        return hash * Prime1 + Prime4;
+    }
+}
+
+uint64_t ValidationCache::Hash(std::string_view bytes, uint64_t seed) {
+    using namespace xxh64;
+
+    const char* p = bytes.data();
+    const char* end = p + bytes.size();
+    uint64_t hash;
+
+    if (bytes.size() >= 32) {
+        uint64_t v1 = seed + Prime1 + Prime2;
+        uint64_t v2 = seed + Prime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - Prime1;
+
+        for (; end - p >= 32; p += 32) {
+            v1 = Round(v1, Read64(p));
+            v2 = Round(v2, Read64(p + 8));
+            v3 = Round(v3, Read64(p + 16));
+            v4 = Round(v4, Read64(p + 24));
+        }
+
+        hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+        hash = Merge(hash, v1);
+        hash = Merge(hash, v2);
+        hash = Merge(hash, v3);
+        hash = Merge(hash, v4);
+    }
+    else {
+        hash = seed + Prime5;
+    }
+
+    hash += bytes.size();
+
+    for (; end - p >= 8; p += 8)
+        hash = std::rotl(hash ^ Round(0, Read64(p)), 27) * Prime1 + Prime4;
+
+    if (end - p >= 4) {
+        hash = std::rotl(hash ^ (Read32(p) * Prime1), 23) * Prime2 + Prime3;
+        p += 4;
+    }
+
+    for (; p < end; p++)
+        hash = std::rotl(hash ^ (static_cast<uint8_t>(*p) * Prime5), 11) * Prime1;
+
+    hash ^= hash >> 33;
+    hash *= Prime2;
+    hash ^= hash >> 29;
+    hash *= Prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+static void Append64(std::string& out, uint64_t value) {
+    char bytes[sizeof(value)];
+    std::memcpy(bytes, &value, sizeof(value));
+    out.append(bytes, sizeof(value));
+}
+
+static bool IsEntry(const std::filesystem::path& path) {
+    return path.extension() == entryExtension;
+}
+
+static bool IsTemporary(const std::filesystem::path& path) {
+    return path.filename().string().starts_with(temporaryPrefix);
+}
+
+ValidationCache::ValidationCache(std::filesystem::path directory, const Options& options) : directory(std::move(directory)), options(options) {
+    std::random_device random;
+    instance = static_cast<uint64_t>(random()) << 32 | random();
+
+    std::error_code error;
+    std::filesystem::create_directories(this->directory, error);
+
+    uint64_t total = 0;
+
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(this->directory, error)) {
+        if (IsEntry(entry.path()))
+            total += entry.file_size(error);
+    }
+
+    bytes = total;
+
+    if (bytes > options.maxBytes)
+        Evict();
+}
+
+std::filesystem::path ValidationCache::EntryPath(const Key& key) const {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%016llx%016llx%s", static_cast<unsigned long long>(key.content), static_cast<unsigned long long>(key.schema), entryExtension);
+    return directory / name;
+}
+
+std::optional<std::string> ValidationCache::Load(const Key& key) {
+    const std::filesystem::path path = EntryPath(key);
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+
+    std::string entry;
+    if (file) {
+        const std::streamoff size = file.tellg();
+
+        if (size >= static_cast<std::streamoff>(headerSize + sizeof(uint64_t)) && size <= static_cast<std::streamoff>(maxEntrySize)) {
+            entry.resize(static_cast<size_t>(size));
+            file.seekg(0);
+            file.read(entry.data(), size);
+
+            if (!file)
+                entry.clear();
+        }
+    }
+
+    // The header must repeat the key, so a colliding file name or a file from another layout is a miss
+    std::string expected(entryMagic, sizeof(entryMagic));
+    Append64(expected, key.content);
+    Append64(expected, key.size);
+    Append64(expected, key.schema);
+
+    if (entry.empty() || entry.compare(0, expected.size(), expected) != 0) {
+        misses++;
+        return std::nullopt;
+    }
+
+    const size_t checked = entry.size() - sizeof(uint64_t);
+    const size_t valueSize = checked - headerSize;
+
+    if (xxh64::Read64(entry.data() + expected.size()) != valueSize || xxh64::Read64(entry.data() + checked) != Hash(std::string_view(entry.data(), checked))) {
+        misses++;
+        return std::nullopt;
+    }
+
+    // Recently used entries are the last to be evicted
+    std::error_code error;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+
+    hits++;
+    return entry.substr(headerSize, valueSize);
+}
+
+void ValidationCache::Store(const Key& key, std::string_view value) {
+    std::string entry(entryMagic, sizeof(entryMagic));
+    Append64(entry, key.content);
+    Append64(entry, key.size);
+    Append64(entry, key.schema);
+    Append64(entry, value.size());
+    entry.append(value);
+    Append64(entry, Hash(entry));
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "%s%016llx-%llu", temporaryPrefix, static_cast<unsigned long long>(instance), static_cast<unsigned long long>(temporaryCount++));
+    const std::filesystem::path temporary = directory / name;
+
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(entry.data(), static_cast<std::streamsize>(entry.size()));
+        file.close();
+
+        if (!file) {
+            std::error_code error;
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+
+    const std::filesystem::path path = EntryPath(key);
+
+    // The entry the rename replaces, if any, stops counting towards the size
+    std::error_code error;
+    const uintmax_t previousSize = std::filesystem::file_size(path, error);
+    const uint64_t replaced = error ? 0 : static_cast<uint64_t>(previousSize);
+
+    // Renaming replaces any previous entry in one step, readers never see a partial one
+    std::filesystem::rename(temporary, path, error);
+
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return;
+    }
+
+    stores++;
+
+    // The size as last seen may not include the replaced entry, if another process stored it
+    uint64_t total = bytes.load();
+    uint64_t updated;
+    do {
+        updated = total - std::min(total, replaced) + entry.size();
+    } while (!bytes.compare_exchange_weak(total, updated));
+
+    if (updated > options.maxBytes)
+        Evict();
+}
+
+void ValidationCache::Evict() {
+    // Another thread is already on it
+    std::unique_lock<std::mutex> lock(evictMutex, std::try_to_lock);
+    if (!lock.owns_lock())
+        return;
+
+    struct Entry {
+        std::filesystem::file_time_type used;
+        uint64_t size;
+        std::filesystem::path path;
+    };
+
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+
+    const std::filesystem::file_time_type now = std::filesystem::file_time_type::clock::now();
+    std::error_code error;
+
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory, error)) {
+        const std::filesystem::file_time_type used = entry.last_write_time(error);
+        if (error)
+            continue;
+
+        if (IsTemporary(entry.path())) {
+            if (now - used > staleTemporaryAge)
+                std::filesystem::remove(entry.path(), error);
+            continue;
+        }
+
+        if (!IsEntry(entry.path()))
+            continue;
+
+        const uint64_t size = entry.file_size(error);
+        if (error)
+            continue;
+
+        entries.push_back({ used, size, entry.path() });
+        total += size;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.used < b.used; });
+
+    // Going below the limit leaves room for new entries before the next scan.
+    // Other processes may remove the same entries at the same time, which is harmless.
+    const uint64_t target = options.maxBytes / 4 * 3;
+
+    for (const Entry& entry : entries) {
+        if (total <= target)
+            break;
+
+        if (std::filesystem::remove(entry.path, error))
+            evictions++;
+        total -= entry.size;
+    }
+
+    bytes = total;
+}
+
+ValidationCache::Statistics ValidationCache::GetStatistics() const {
+    return { hits.load(), misses.load(), stores.load(), evictions.load() };
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/**
+ * @class ValidationCache
+ * @brief Persistent store for validation outcomes, keyed by the content of a file and the schema it was validated against.
+ * @note Every entry is a file of its own in one directory. Entries are written to a temporary
+ *       file first and then renamed into place, so any number of threads and processes can
+ *       share the directory: a reader sees either a whole entry or none. Entries carry their
+ *       key and a checksum, anything that does not match is treated as a miss.
+ *       Reading an entry marks it as recently used. Once the entries grow past maxBytes, the
+ *       least recently used ones are removed until they take up three quarters of it.
+ */
+class ValidationCache {
+public:
+    /**
+     * @struct Options
+     * @brief Struct representing how large the cache may grow.
+     */
+    struct Options {
+        uint64_t maxBytes = 64 << 20;   /// Total size of all entries before the oldest are evicted.
+    };
+
+    /**
+     * @struct Key
+     * @brief Struct representing what an outcome depends on.
+     */
+    struct Key {
+        uint64_t content;               /// Hash of the validated bytes.
+        uint64_t size;                  /// Number of validated bytes.
+        uint64_t schema;                /// Fingerprint of the compiled schema.
+    };
+
+    /**
+     * @struct Statistics
+     * @brief Struct representing what this instance did so far. Other processes sharing the directory are not counted.
+     */
+    struct Statistics {
+        uint64_t hits = 0;              /// Loads that found an entry.
+        uint64_t misses = 0;            /// Loads that did not.
+        uint64_t stores = 0;            /// Entries written.
+        uint64_t evictions = 0;         /// Entries removed to stay within maxBytes.
+    };
+
+private:
+    std::filesystem::path directory;    /// Where the entries live.
+    Options options;                    /// The size limit.
+
+    uint64_t instance;                  /// Random number that makes the names of temporary files unique between instances.
+    std::atomic<uint64_t> temporaryCount = 0; /// Makes the names of temporary files unique within this instance.
+    std::atomic<uint64_t> bytes = 0;    /// Size of all entries as last seen, plus what this instance stored since.
+    std::mutex evictMutex;              /// Keeps threads of this instance from evicting at the same time.
+
+    std::atomic<uint64_t> hits = 0;     /// See Statistics.
+    std::atomic<uint64_t> misses = 0;   /// See Statistics.
+    std::atomic<uint64_t> stores = 0;   /// See Statistics.
+    std::atomic<uint64_t> evictions = 0; /// See Statistics.
+
+    /**
+     * @brief Gets the path of the entry for a key.
+     */
+    std::filesystem::path EntryPath(const Key& key) const;
+
+    /**
+     * @brief Removes the least recently used entries until they fit in three quarters of maxBytes.
+     */
+    void Evict();
+
+public:
+    /**
+     * @brief Constructor for ValidationCache.
+     * @param directory Where the entries live. Created if it does not exist.
+     */
+    explicit ValidationCache(std::filesystem::path directory) : ValidationCache(std::move(directory), Options()) {}
+
+    /**
+     * @brief Constructor for ValidationCache.
+     * @param directory Where the entries live. Created if it does not exist.
+     * @param options The size limit.
+     */
+    ValidationCache(std::filesystem::path directory, const Options& options);
+
+    ValidationCache(const ValidationCache&) = delete;
+    ValidationCache& operator=(const ValidationCache&) = delete;
+
+    /**
+     * @brief Hashes bytes for use in a Key. XXH64, so several GB/s.
+     * @param bytes The bytes to hash.
+     * @param seed Starting value, to derive unrelated hashes of the same bytes.
+     * @return The 64-bit hash.
+     */
+    static uint64_t Hash(std::string_view bytes, uint64_t seed = 0);
+
+    /**
+     * @brief Looks up the entry for a key.
+     * @param key The key.
+     * @return The stored value, std::nullopt if there is no intact entry for the key.
+     */
+    std::optional<std::string> Load(const Key& key);
+
+    /**
+     * @brief Stores a value for a key, replacing any entry it had.
+     * @param key The key.
+     * @param value The value.
+     * @note Failing to write is not an error, the entry is simply missing next time.
+     */
+    void Store(const Key& key, std::string_view value);
+
+    /**
+     * @brief Gets the counters of this instance.
+     */
+    Statistics GetStatistics() const;
+};
@@ -1,4 +1,7 @@
 #include "YamlParser.h"
+#include "InputSource.h"
+
+#include <algorithm>
 
 void YamlParser::Advance() {
     column++;
@@ -9,11 +12,10 @@ void YamlParser::Advance() {
         column = 1;
     }
 
-    currChar = peekChar;
-    stream.get(peekChar);
+    if (cursor < end)
+        cursor++;
 
-    isEOF = isPeekEOF;
-    isPeekEOF = stream.eof();
+    Load();
 }
 
 void YamlParser::SkipWhitespace() {
@@ -21,48 +23,52 @@ void YamlParser::SkipWhitespace() {
         Advance();
 }
 
-void YamlParser::Expect(char c, ErrorType error) {
+bool YamlParser::Expect(char c, ErrorType error) {
     if (currChar != c) {
-        throw error;
+        return Fail(error);
     }
     Advance();
+    return true;
 }
 
-YamlValue YamlParser::ParseValue() {
+bool YamlParser::ParseValue() {
 
     // JSON Array or Object
     if (currChar == '[')
-        return std::make_shared<Array>(ParseJsonArray());
+        return ParseJsonArray();
     if (currChar == '{')
-        return std::make_shared<Object>(ParseJsonObject());
+        return ParseJsonObject();
     
 
     // YAML Array
     if (currChar == '-' && peekChar == ' ')
-        return std::make_shared<Array>(ParseYamlArray());
+        return ParseYamlArray();
     
     // TODO: handle YAML Object
 
     // Must be a Scalar
     // https://symfony.com/doc/current/reference/formats/yaml.html#scalars
 
-    std::string value;
+    const SourcePosition start = Position();
+
     bool isSingleQuoted = currChar == '\'';
     bool isDoubleQuoted = currChar == '"';
 
     if (isSingleQuoted || isDoubleQuoted)
         Advance();
 
+    BeginScalar();
+
     uint32_t spaceCount = 0;
 
     // TODO: Handle multi-line strings
     //bool isMultiLine = currChar == '>' || currChar == '|';
 
     // Extract the value
-    while (!(valueEndChars.find(currChar) != std::string::npos && !isSingleQuoted && !isDoubleQuoted)) {
+    while (!(isValueEnd(currChar) && !isSingleQuoted && !isDoubleQuoted)) {
         if (isEOF) {
             if (isSingleQuoted || isDoubleQuoted)
-                throw ErrorType::UnexpectedEndOfFileError;
+                return Fail(ErrorType::UnexpectedEndOfFileError);
 
             break;
         }
@@ -73,13 +79,13 @@ YamlValue YamlParser::ParseValue() {
 
             // " characters are not valid inside an un-quoted string
             if (!isDoubleQuoted) {
-                throw ErrorType::InvalidScalarError;
+                return Fail(ErrorType::InvalidScalarError);
             }
 
             Advance(); // Skip " character
 
             // End of quotation
-            return String(value); // Quotations always return strings
+            return handler->Scalar(String(CurrentScalar()), start); // Quotations always return strings
         }
 
         // Handle ' character
@@ -88,14 +94,14 @@ YamlValue YamlParser::ParseValue() {
 
             // ' characters are not valid inside an un-quoted string
             if (!isSingleQuoted) {
-                throw ErrorType::InvalidScalarError;
+                return Fail(ErrorType::InvalidScalarError);
             }
 
             // ' characters are escaped by ' characters in a single-quote string
             // eg. 'this ''string'' has '' characters inside,
             // Which gives out "this 'string' has ' characters inside"
             if (peekChar == '\'') {
-                value.push_back('\'');
+                AppendUnescaped('\'');
                 Advance();
                 Advance();
                 continue;
@@ -104,12 +110,12 @@ YamlValue YamlParser::ParseValue() {
             Advance(); // Skip ' character
 
             // End of quotation
-            return String(value); // Quotations always return strings
+            return handler->Scalar(String(CurrentScalar()), start); // Quotations always return strings
         }
 
         // Handle invalid characters
-        else if (!isSingleQuoted && !isDoubleQuoted && invalidValueChars.find(currChar) != std::string::npos) {
-            throw ErrorType::UnexpectedCharacterError;
+        else if (!isSingleQuoted && !isDoubleQuoted && isInvalidValue(currChar)) {
+            return Fail(ErrorType::UnexpectedCharacterError);
         }
 
         else if (currChar == ' ' && !isSingleQuoted && !isDoubleQuoted) {
@@ -118,47 +124,67 @@ YamlValue YamlParser::ParseValue() {
             continue;
         }
 
-        // If we encounter a normal character, and we have un-added spaces
+        // If we encounter a normal character, and we have un-added spaces.
+        // Unless the scalar is already built in scratch, the spaces are
+        // still part of the input and get covered by AppendCurrent.
         else if(spaceCount > 0) {
-            for(uint32_t i = 0; i < spaceCount; i++)
-                value.push_back(' ');
+            if (scalarOwned)
+                scratch.append(spaceCount, ' ');
 
             spaceCount = 0;
         }
 
-        value.push_back(currChar);
+        AppendCurrent();
         Advance();
+
+        // Take everything up to the next character that needs a look in one go
+        AppendPlain(isSingleQuoted || isDoubleQuoted ? StructuralIndex::Quoted : StructuralIndex::Unquoted);
     }
 
     SkipWhitespace();
 
     if (currChar == ':')
-        return std::make_shared<Object>(ParseYamlObject(value));
-
-    if (auto opt = IsBoolean(value); opt.has_value())
-        return Boolean(opt.value());
-    else if (IsNumber(value))
-        return Number(value);
-    else if (IsNull(value))
-        return Null();
-    else if(IsTimestamp(value))
-        return Timestamp(value);
-    return String(value);
-}
+        return ParseYamlObject(start);
 
-std::string YamlParser::ParseObjectKey() {
-    std::string key;
+    std::string_view value = CurrentScalar();
 
+    // Each classifier is only called once the ones before it did not match
+    if (auto opt = IsBoolean(value); opt.has_value()) {
+        CountClassifierCalls(1);
+        return handler->Scalar(Boolean(opt.value()), start);
+    }
+    else if (IsNumber(value)) {
+        CountClassifierCalls(2);
+        return handler->Scalar(Number(value), start);
+    }
+    else if (IsNull(value)) {
+        CountClassifierCalls(3);
+        return handler->Scalar(Null(), start);
+    }
+    else if(IsTimestamp(value)) {
+        CountClassifierCalls(4);
+        return handler->Scalar(Timestamp(value), start);
+    }
+
+    CountClassifierCalls(4);
+    return handler->Scalar(String(value), start);
+}
+
+bool YamlParser::ParseObjectKey() {
     bool isSingleQuoted = currChar == '\'';
     bool isDoubleQuoted = currChar == '"';
 
     if (isSingleQuoted || isDoubleQuoted) Advance();
 
+    BeginScalar();
+
     while (!(currChar == ':' && !isSingleQuoted && !isDoubleQuoted)) {
+        if (isEOF)
+            return Fail(ErrorType::UnexpectedEndOfFileError);
 
         // Check for invalid quotation marks
         if ((currChar == '\'' || currChar == '"') && !isDoubleQuoted && !isSingleQuoted) {
-            throw ErrorType::UnexpectedCharacterError;
+            return Fail(ErrorType::UnexpectedCharacterError);
         }
 
         // Handle single-quotes
@@ -166,7 +192,7 @@ std::string YamlParser::ParseObjectKey() {
             // Single quotation marks are escaped by single
             // quotation marks in a YAML string
             if (peekChar == '\'') {
-                key.push_back('\'');
+                AppendUnescaped('\'');
                 Advance();
                 Advance();
                 continue;
@@ -175,7 +201,7 @@ std::string YamlParser::ParseObjectKey() {
             Advance(); // Skip ' character
 
             // End of key
-            return key;
+            return true;
         }
 
         // Handle " character
@@ -183,20 +209,20 @@ std::string YamlParser::ParseObjectKey() {
         else if (currChar == '"' && !isSingleQuoted) {
             // " characters are not valid inside an un-quoted string
             if (!isDoubleQuoted) {
-                throw ErrorType::UnexpectedCharacterError;
+                return Fail(ErrorType::UnexpectedCharacterError);
             }
 
             Advance(); // Skip " character
 
             // End of quotation
-            return key; // Quotations always return strings
+            return true; // Quotations always return strings
         }
 
         // Backslash-escaped characters not handled by std::ifstream
         else if (currChar == '\\' && isDoubleQuoted) {
             // Escaped " character in double quoted string
             if (peekChar == '"' && isDoubleQuoted) {
-                key.push_back('"');
+                AppendUnescaped('"');
                 Advance();
                 Advance();
                 continue;
@@ -205,35 +231,48 @@ std::string YamlParser::ParseObjectKey() {
             Advance(); // Skip " character
 
             // End of key
-            return key;
+            return true;
         }
 
         // Search for un-quoted special characters
-        else if (!isSingleQuoted && !isDoubleQuoted && invalidKeyChars.find(currChar) != std::string::npos) {
-            throw ErrorType::UnexpectedCharacterError;
+        else if (!isSingleQuoted && !isDoubleQuoted && isInvalidKey(currChar)) {
+            return Fail(ErrorType::UnexpectedCharacterError);
         }
 
-        key.push_back(currChar);
+        AppendCurrent();
         Advance();
+        AppendPlain(isSingleQuoted || isDoubleQuoted ? StructuralIndex::Quoted : StructuralIndex::Unquoted);
     }
 
-    return key;
+    return true;
 }
 
-std::optional<bool> YamlParser::IsBoolean(const std::string& v) {
+std::optional<bool> YamlParser::IsBoolean(std::string_view v) {
     if (v == "true" || v == "True" || v == "TRUE") return true;
     else if (v == "false" || v == "False" || v == "FALSE") return false;
     return std::nullopt;
 }
 
-bool YamlParser::IsNumber(const std::string& v) {
+static bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+/// Consumes a run of [0-9] starting at `i` and returns how many digits were consumed.
+static size_t ScanDigits(std::string_view v, size_t& i) {
+    size_t start = i;
+    while (i < v.size() && IsDigit(v[i]))
+        i++;
+    return i - start;
+}
+
+bool YamlParser::IsNumber(std::string_view v) {
     if (v == ".nan"  || v == ".NaN"  || v == ".NAN"
      || v == ".inf"  || v == ".Inf"  || v == ".INF"
      || v == "-.inf" || v == "-.Inf" || v == "-.INF") return true;
 
     // Hexadecimal numbers
-    if (v[0] == '0' && v[1] == 'x' && v.size() > 2) {
-        for (int i = 2; i < v.size(); i++) {
+    if (v.size() > 2 && v[0] == '0' && v[1] == 'x') {
+        for (size_t i = 2; i < v.size(); i++) {
             if (!(v[i] >= '0' && v[i] <= '9') &&
                 !(v[i] >= 'A' && v[i] <= 'F') &&
                 !(v[i] >= 'a' && v[i] <= 'f')) return false;
@@ -242,35 +281,279 @@ bool YamlParser::IsNumber(const std::string& v) {
     }
 
     // Octadecimal numbers
-    else if (v[0] == '0' && v[1] == 'o' && v.size() > 2) {
-        for (int i = 2; i < v.size(); i++) {
+    else if (v.size() > 2 && v[0] == '0' && v[1] == 'o') {
+        for (size_t i = 2; i < v.size(); i++) {
             if (v[i] < '0' || v[i] > '7') return false;
         }
         return true;
     }
 
-    return std::regex_match(v, std::regex(R"([-+]?(\.[0-9]+|[0-9]+(\.[0-9]*)?)([eE][-+]?[0-9]+)?)"));
+    // Decimal numbers: [-+]?(\.[0-9]+|[0-9]+(\.[0-9]*)?)([eE][-+]?[0-9]+)?
+    size_t i = 0;
+
+    if (i < v.size() && (v[i] == '-' || v[i] == '+'))
+        i++;
+
+    if (i < v.size() && v[i] == '.') {
+        i++;
+        if (ScanDigits(v, i) == 0) return false;
+    }
+    else {
+        if (ScanDigits(v, i) == 0) return false;
+
+        if (i < v.size() && v[i] == '.') {
+            i++;
+            ScanDigits(v, i);
+        }
+    }
+
+    if (i < v.size() && (v[i] == 'e' || v[i] == 'E')) {
+        i++;
+        if (i < v.size() && (v[i] == '-' || v[i] == '+'))
+            i++;
+        if (ScanDigits(v, i) == 0) return false;
+    }
+
+    return i == v.size();
 }
 
-bool YamlParser::IsNull(const std::string& v) {
+bool YamlParser::IsNull(std::string_view v) {
     return v.empty() || v == "~" || v == "null" || v == "Null" || v == "NULL";
 }
 
-bool YamlParser::IsTimestamp(const std::string& v) {
-    // Regex taken from https://www.myintervals.com/blog/2009/05/20/iso-8601-date-validation-that-doesnt-suck/
-    return std::regex_match(v, std::regex(R"(^([\+-]?\d{4}(?!\d{2}\b))((-?)((0[1-9]|1[0-2])(\3([12]\d|0[1-9]|3[01]))?|W([0-4]\d|5[0-2])(-?[1-7])?|(00[1-9]|0[1-9]\d|[12]\d{2}|3([0-5]\d|6[1-6])))([T\s]((([01]\d|2[0-3])((:?)[0-5]\d)?|24\:?00)([\.,]\d+(?!:))?)?(\17[0-5]\d([\.,]\d+)?)?([zZ]|([\+-])([01]\d|2[0-3]):?([0-5]\d)?)?)?)?$)"));
+/*
+ * Hand-written matcher for the ISO8601 regex from
+ * https://www.myintervals.com/blog/2009/05/20/iso-8601-date-validation-that-doesnt-suck/
+ *
+ *   ^([\+-]?\d{4}(?!\d{2}\b))((-?)((0[1-9]|1[0-2])(\3([12]\d|0[1-9]|3[01]))?|W([0-4]\d|5[0-2])(-?[1-7])?|
+ *   (00[1-9]|0[1-9]\d|[12]\d{2}|3([0-5]\d|6[1-6])))([T\s]((([01]\d|2[0-3])((:?)[0-5]\d)?|24\:?00)([\.,]\d+(?!:))?)?
+ *   (\17[0-5]\d([\.,]\d+)?)?([zZ]|([\+-])([01]\d|2[0-3]):?([0-5]\d)?)?)?)?$
+ *
+ * Every optional part and alternative of the regex is tried in the same order as a
+ * backtracking regex engine would, but all parts are fixed-width except the fractions,
+ * so each candidate is a couple of character comparisons instead of an NFA simulation.
+ * Group 17 (the separator between hours and minutes) is referenced again before the
+ * seconds; as in std::regex, a backreference to a group that did not participate fails.
+ */
+namespace timestamp_scanner {
+
+    /// Value of capture group 17 when it did not participate in the match.
+    constexpr int Unmatched = -1;
+
+    static bool At(std::string_view v, size_t i, char c) {
+        return i < v.size() && v[i] == c;
+    }
+
+    static bool DigitAt(std::string_view v, size_t i) {
+        return i < v.size() && IsDigit(v[i]);
+    }
+
+    static bool InRange(std::string_view v, size_t i, char lo, char hi) {
+        return i < v.size() && v[i] >= lo && v[i] <= hi;
+    }
+
+    /// \s in std::regex for char: space, \t, \n, \v, \f, \r
+    static bool IsSpace(char c) {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+    static bool IsWordChar(char c) {
+        return IsDigit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+    }
+
+    /// ([01]\d|2[0-3])
+    static bool Hour(std::string_view v, size_t i) {
+        return (InRange(v, i, '0', '1') && DigitAt(v, i + 1)) || (At(v, i, '2') && InRange(v, i + 1, '0', '3'));
+    }
+
+    /// [0-5]\d
+    static bool Minute(std::string_view v, size_t i) {
+        return InRange(v, i, '0', '5') && DigitAt(v, i + 1);
+    }
+
+    /// (0[1-9]|1[0-2])
+    static bool Month(std::string_view v, size_t i) {
+        return (At(v, i, '0') && InRange(v, i + 1, '1', '9')) || (At(v, i, '1') && InRange(v, i + 1, '0', '2'));
+    }
+
+    /// ([12]\d|0[1-9]|3[01])
+    static bool Day(std::string_view v, size_t i) {
+        return (InRange(v, i, '1', '2') && DigitAt(v, i + 1))
+            || (At(v, i, '0') && InRange(v, i + 1, '1', '9'))
+            || (At(v, i, '3') && InRange(v, i + 1, '0', '1'));
+    }
+
+    /// ([0-4]\d|5[0-2])
+    static bool Week(std::string_view v, size_t i) {
+        return (InRange(v, i, '0', '4') && DigitAt(v, i + 1)) || (At(v, i, '5') && InRange(v, i + 1, '0', '2'));
+    }
+
+    /// (00[1-9]|0[1-9]\d|[12]\d{2}|3([0-5]\d|6[1-6]))
+    static bool OrdinalDay(std::string_view v, size_t i) {
+        if (!DigitAt(v, i) || !DigitAt(v, i + 1) || !DigitAt(v, i + 2))
+            return false;
+
+        // 360 is not matched by 3([0-5]\d|6[1-6])
+        int day = (v[i] - '0') * 100 + (v[i + 1] - '0') * 10 + (v[i + 2] - '0');
+        return day >= 1 && day <= 366 && day != 360;
+    }
+
+    /// ([zZ]|([\+-])([01]\d|2[0-3]):?([0-5]\d)?)?$
+    static bool MatchZone(std::string_view v, size_t i) {
+        if (i == v.size())
+            return true;
+
+        if (v[i] == 'z' || v[i] == 'Z')
+            return i + 1 == v.size();
+
+        if ((v[i] != '+' && v[i] != '-') || !Hour(v, i + 1))
+            return false;
+
+        i += 3;
+        if (At(v, i, ':'))
+            i++;
+
+        return i == v.size() || (i + 2 == v.size() && Minute(v, i));
+    }
+
+    /// (\17[0-5]\d([\.,]\d+)?)? followed by the zone
+    static bool MatchSecondsAndZone(std::string_view v, size_t i, int timeSeparator) {
+        if (timeSeparator == 0 || (timeSeparator == ':' && At(v, i, ':'))) {
+            size_t j = timeSeparator == ':' ? i + 1 : i;
+
+            if (Minute(v, j)) {
+                j += 2;
+
+                // Only the greedy fraction can be followed by a zone or the end,
+                // giving back digits would leave a digit in front of either.
+                if ((At(v, j, '.') || At(v, j, ',')) && DigitAt(v, j + 1)) {
+                    size_t k = j + 1;
+                    ScanDigits(v, k);
+                    if (MatchZone(v, k))
+                        return true;
+                }
+
+                if (MatchZone(v, j))
+                    return true;
+            }
+        }
+
+        return MatchZone(v, i);
+    }
+
+    /// ([\.,]\d+(?!:))? after the hour/minute part, then the rest of the time
+    static bool MatchFractionAndRest(std::string_view v, size_t i, int timeSeparator) {
+        if ((At(v, i, '.') || At(v, i, ',')) && DigitAt(v, i + 1)) {
+            size_t end = i + 1;
+            size_t digits = ScanDigits(v, end);
+
+            // \d+ backtracks one digit at a time while the lookahead rejects a ':'
+            for (size_t n = digits; n >= 1; n--) {
+                size_t k = i + 1 + n;
+                if (!At(v, k, ':') && MatchSecondsAndZone(v, k, timeSeparator))
+                    return true;
+            }
+        }
+
+        return MatchSecondsAndZone(v, i, timeSeparator);
+    }
+
+    /// ([T\s](time)?(seconds)?(zone)?)?$
+    static bool MatchTime(std::string_view v, size_t i) {
+        if (i == v.size())
+            return true;
+
+        if (v[i] != 'T' && !IsSpace(v[i]))
+            return false;
+
+        i++;
+
+        // ([01]\d|2[0-3])((:?)[0-5]\d)?
+        if (Hour(v, i)) {
+            if (At(v, i + 2, ':') && Minute(v, i + 3) && MatchFractionAndRest(v, i + 5, ':'))
+                return true;
+            if (Minute(v, i + 2) && MatchFractionAndRest(v, i + 4, 0))
+                return true;
+            if (MatchFractionAndRest(v, i + 2, Unmatched))
+                return true;
+        }
+
+        // 24\:?00
+        if (At(v, i, '2') && At(v, i + 1, '4')) {
+            size_t j = At(v, i + 2, ':') ? i + 3 : i + 2;
+            if (At(v, j, '0') && At(v, j + 1, '0') && MatchFractionAndRest(v, j + 2, Unmatched))
+                return true;
+        }
+
+        // No time of day at all
+        return MatchSecondsAndZone(v, i, Unmatched);
+    }
+
+    static bool MatchDate(std::string_view v, size_t i, bool dashed) {
+        size_t sep = dashed ? 1 : 0;
+
+        // (0[1-9]|1[0-2])(\3([12]\d|0[1-9]|3[01]))?
+        if (Month(v, i)) {
+            if ((!dashed || At(v, i + 2, '-')) && Day(v, i + 2 + sep) && MatchTime(v, i + 4 + sep))
+                return true;
+            if (MatchTime(v, i + 2))
+                return true;
+        }
+
+        // W([0-4]\d|5[0-2])(-?[1-7])?
+        if (At(v, i, 'W') && Week(v, i + 1)) {
+            size_t j = i + 3;
+            if (At(v, j, '-') && InRange(v, j + 1, '1', '7') && MatchTime(v, j + 2))
+                return true;
+            if (InRange(v, j, '1', '7') && MatchTime(v, j + 1))
+                return true;
+            if (MatchTime(v, j))
+                return true;
+        }
+
+        // (00[1-9]|0[1-9]\d|[12]\d{2}|3([0-5]\d|6[1-6]))
+        return OrdinalDay(v, i) && MatchTime(v, i + 3);
+    }
+}
+
+bool YamlParser::IsTimestamp(std::string_view v) {
+    using namespace timestamp_scanner;
+
+    // [\+-]?\d{4}
+    size_t i = 0;
+    if (At(v, i, '+') || At(v, i, '-'))
+        i++;
+
+    for (size_t end = i + 4; i < end; i++) {
+        if (!DigitAt(v, i))
+            return false;
+    }
+
+    // (?!\d{2}\b)
+    if (DigitAt(v, i) && DigitAt(v, i + 1) && (i + 2 == v.size() || !IsWordChar(v[i + 2])))
+        return false;
+
+    // Year only
+    if (i == v.size())
+        return true;
+
+    // (-?) is captured as group 3 and repeated between month and day
+    return (At(v, i, '-') && MatchDate(v, i + 1, true)) || MatchDate(v, i, false);
 }
 
-Object YamlParser::ParseYamlObject(const std::string& firstKey) {
-    Object obj;
-    indentStack.push(column - firstKey.size());
+bool YamlParser::ParseYamlObject(SourcePosition firstKey) {
+    indentStack.push(column - CurrentScalar().size());
+
+    if (!handler->BeginObject(firstKey) || !handler->Key(CurrentScalar(), firstKey))
+        return false;
 
     SkipWhitespace();
-    Expect(':', ErrorType::UnexpectedCharacterError);
+    if (!Expect(':', ErrorType::UnexpectedCharacterError))
+        return false;
     SkipWhitespace();
 
-    YamlValue value = ParseValue();
-    obj.Set(firstKey, value);
+    if (!ParseValue())
+        return false;
 
     while (true) {
         SkipWhitespace();
@@ -282,130 +565,462 @@ Object YamlParser::ParseYamlObject(const std::string& firstKey) {
             break;
 
         else if (column != indentStack.top())
-            throw ErrorType::InvalidIndentationError;
+            return Fail(ErrorType::InvalidIndentationError);
 
         // If we are on the same indentation level,
         // we can expect another item
 
-        std::string key = ParseObjectKey();
+        const SourcePosition key = Position();
+        if (!ParseObjectKey() || !handler->Key(CurrentScalar(), key))
+            return false;
 
         SkipWhitespace();
-        Expect(':', ErrorType::UnexpectedCharacterError);
+        if (!Expect(':', ErrorType::UnexpectedCharacterError))
+            return false;
         SkipWhitespace();
 
-        YamlValue value = ParseValue();
-
-        obj.Set(key, value);
+        if (!ParseValue())
+            return false;
     }
 
     indentStack.pop();
-    return obj;
+    return handler->EndObject(Position());
 }
 
-Object YamlParser::ParseJsonObject() {
-    Object obj;
+bool YamlParser::ParseJsonObject() {
+    const SourcePosition start = Position();
 
-    Expect('{', ErrorType::UnexpectedCharacterError);
+    if (!Expect('{', ErrorType::UnexpectedCharacterError))
+        return false;
     SkipWhitespace();
 
+    if (!handler->BeginObject(start))
+        return false;
+
     while (currChar != '}') {
-        std::string key = ParseObjectKey();
+        if (isEOF)
+            return Fail(ErrorType::UnexpectedEndOfFileError);
+
+        const SourcePosition key = Position();
+        if (!ParseObjectKey() || !handler->Key(CurrentScalar(), key))
+            return false;
 
         SkipWhitespace();
-        Expect(':', ErrorType::UnexpectedCharacterError);
+        if (!Expect(':', ErrorType::UnexpectedCharacterError))
+            return false;
         SkipWhitespace();
 
-        YamlValue value = ParseValue();
-
-        obj.Set(key, value);
+        if (!ParseValue())
+            return false;
 
         SkipWhitespace();
         if (currChar == ',') {
             Advance();
             SkipWhitespace();
         }
+        else if (currChar != '}' && !isEOF) {
+            return Fail(ErrorType::UnexpectedCharacterError);
+        }
     }
 
-    Expect('}', ErrorType::UnexpectedCharacterError); // Skip } character
+    const SourcePosition end = Position();
+    if (!Expect('}', ErrorType::UnexpectedCharacterError)) // Skip } character
+        return false;
 
-    return obj;
+    return handler->EndObject(end);
 }
 
-Array YamlParser::ParseYamlArray() {
-    Array arr;
+bool YamlParser::ParseYamlArray() {
+    const SourcePosition start = Position();
     indentStack.push(column);
 
-    Expect('-', ErrorType::UnexpectedCharacterError);
-    Expect(' ', ErrorType::UnexpectedCharacterError);
+    if (!Expect('-', ErrorType::UnexpectedCharacterError) || !Expect(' ', ErrorType::UnexpectedCharacterError))
+        return false;
+
+    if (!handler->BeginArray(start))
+        return false;
 
     while (true) {
-        arr.PushBack(ParseValue());
+        if (!ParseValue())
+            return false;
 
         if (isEOF)
             break;
 
         SkipWhitespace();
 
-        if (column < indentStack.top())
+        if (isEOF || column < indentStack.top())
             break;
 
         // If we are on the same indentation level, we can expect a new list item
-        Expect('-', ErrorType::UnexpectedCharacterError);
-        Expect(' ', ErrorType::UnexpectedCharacterError);
+        if (!Expect('-', ErrorType::UnexpectedCharacterError) || !Expect(' ', ErrorType::UnexpectedCharacterError))
+            return false;
     }
 
     indentStack.pop();
-    return arr;
+    return handler->EndArray(Position());
 }
 
-Array YamlParser::ParseJsonArray() {
-    Array arr;
+bool YamlParser::ParseJsonArray() {
+    const SourcePosition start = Position();
 
-    Expect('[', ErrorType::UnexpectedCharacterError);
+    if (!Expect('[', ErrorType::UnexpectedCharacterError))
+        return false;
     SkipWhitespace();
 
+    if (!handler->BeginArray(start))
+        return false;
+
     while (currChar != ']') {
-        arr.PushBack(ParseValue());
+        if (isEOF)
+            return Fail(ErrorType::UnexpectedEndOfFileError);
+
+        if (!ParseValue())
+            return false;
 
-        if (currChar == ',') Advance();
-        
         SkipWhitespace();
+        if (currChar == ',') {
+            Advance();
+            SkipWhitespace();
+        }
+        else if (currChar != ']' && !isEOF) {
+            return Fail(ErrorType::UnexpectedCharacterError);
+        }
     }
 
+    const SourcePosition end = Position();
     Advance(); // Skip ']'
 
-    return arr;
+    return handler->EndArray(end);
 }
 
+/**
+ * @class YamlParser::StatisticsHandler
+ * @brief YamlEventHandler that counts the events on their way to another handler, and times that handler.
+ */
+class YamlParser::StatisticsHandler : public YamlEventHandler {
+private:
+    YamlEventHandler& handler;      /// The handler that receives the events.
+    Statistics& statistics;         /// Receives the counts.
+    uint64_t depth = 0;             /// Objects and arrays open right now.
+
+    /**
+     * @brief Passes an event on to the handler, timing it, and takes over a failure it reports.
+     * @param event Callable that passes the event on and returns what the handler returned.
+     * @return What the handler returned.
+     */
+    template<typename F>
+    bool Forward(F event) {
+        bool proceed;
+        {
+            PhaseTimer timer(handlerNanoseconds);
+            proceed = event();
+        }
+
+        if (!proceed && handler.failure.has_value()) {
+            if (handler.failurePosition.has_value())
+                return Fail(handler.failure.value(), handler.failurePosition.value());
+            return Fail(handler.failure.value());
+        }
+        return proceed;
+    }
+
+public:
+    uint64_t handlerNanoseconds = 0; /// Time spent in the handler.
+
+    StatisticsHandler(YamlEventHandler& handler, Statistics& statistics) : handler(handler), statistics(statistics) {}
+
+    bool BeginObject(SourcePosition position) override {
+        statistics.objects++;
+        statistics.maxDepth = std::max(statistics.maxDepth, ++depth);
+        return Forward([&] { return handler.BeginObject(position); });
+    }
+
+    bool Key(std::string_view key, SourcePosition position) override {
+        statistics.keys++;
+        return Forward([&] { return handler.Key(key, position); });
+    }
+
+    bool EndObject(SourcePosition position) override {
+        depth--;
+        return Forward([&] { return handler.EndObject(position); });
+    }
+
+    bool BeginArray(SourcePosition position) override {
+        statistics.arrays++;
+        statistics.maxDepth = std::max(statistics.maxDepth, ++depth);
+        return Forward([&] { return handler.BeginArray(position); });
+    }
+
+    bool EndArray(SourcePosition position) override {
+        depth--;
+        return Forward([&] { return handler.EndArray(position); });
+    }
+
+    bool Scalar(const YamlValue& value, SourcePosition position) override {
+        if (std::holds_alternative<String>(value))
+            statistics.strings++;
+        else if (std::holds_alternative<Number>(value))
+            statistics.numbers++;
+        else if (std::holds_alternative<Boolean>(value))
+            statistics.booleans++;
+        else if (std::holds_alternative<Null>(value))
+            statistics.nulls++;
+        else
+            statistics.timestamps++;
+
+        return Forward([&] { return handler.Scalar(value, position); });
+    }
+};
+
+/**
+ * @class YamlParser::DocumentBuilder
+ * @brief YamlEventHandler that builds the Document returned by YamlParser::Parse().
+ */
+class YamlParser::DocumentBuilder : public YamlEventHandler {
+private:
+    /**
+     * @struct Frame
+     * @brief An Object or Array that is still being parsed.
+     */
+    struct Frame {
+        Object* object = nullptr;   /// The open Object, if any.
+        Array* array = nullptr;     /// The open Array, if any.
+        std::string_view key;       /// The key the next value of object belongs to.
+        SourcePosition keyPosition; /// Where that key starts, for a DuplicateKeyError.
+    };
+
+    YamlParser& parser;             /// The parser, used to keep keys and scalars in its document.
+    std::pmr::vector<Frame> stack;  /// The open containers, innermost last.
+
+    bool Add(const YamlValue& value) {
+        if (stack.empty()) {
+            root = value;
+            return true;
+        }
+
+        Frame& top = stack.back();
+        if (top.object == nullptr) {
+            top.array->PushBack(value);
+            return true;
+        }
+
+        // Emplace looks the key up anyway, so duplicates are only detected here, once the value arrives
+        if (!top.object->Emplace(top.key, value))
+            return Fail(ErrorType::DuplicateKeyError, top.keyPosition);
+        return true;
+    }
+
+public:
+    YamlValue root = Null();        /// The first value of the input.
+
+    DocumentBuilder(YamlParser& parser) : parser(parser), stack(parser.resource) {}
+
+    bool BeginObject(SourcePosition) override {
+        Object* object = parser.document->NewObject();
+        if (!Add(object))
+            return false;
+
+        stack.push_back({ object, nullptr, {}, {} });
+        return true;
+    }
+
+    bool Key(std::string_view, SourcePosition position) override {
+        Frame& top = stack.back();
+        top.key = parser.KeepScalar();
+        top.keyPosition = position;
+        return true;
+    }
+
+    bool EndObject(SourcePosition) override {
+        stack.pop_back();
+        return true;
+    }
+
+    bool BeginArray(SourcePosition) override {
+        Array* array = parser.document->NewArray();
+        if (!Add(array))
+            return false;
+
+        stack.push_back({ nullptr, array, {}, {} });
+        return true;
+    }
+
+    bool EndArray(SourcePosition) override {
+        stack.pop_back();
+        return true;
+    }
+
+    bool Scalar(const YamlValue& value, SourcePosition) override {
+        // The value views the scalar being read, which may not outlive the parse
+        if (std::holds_alternative<String>(value))
+            return Add(String(parser.KeepScalar()));
+        if (std::holds_alternative<Number>(value))
+            return Add(Number(parser.KeepScalar()));
+        if (std::holds_alternative<Timestamp>(value))
+            return Add(Timestamp(parser.KeepScalar()));
+        return Add(value);
+    }
+};
+
 ParserResult YamlParser::Parse() {
-    try {
-        try {
-            YamlValue result = ParseValue();
+    // Counts the arena blocks of the document, only when Statistics are collected
+    std::shared_ptr<CountingResource> counter;
+    if constexpr (Statistics::Enabled) {
+        // Without an upstream, the counter and the document are allocated from resource like everything else
+        if (upstream != nullptr)
+            counter = std::make_shared<CountingResource>(upstream);
+        else
+            counter = std::allocate_shared<CountingResource>(std::pmr::polymorphic_allocator<CountingResource>(resource), std::shared_ptr<std::pmr::memory_resource>(std::shared_ptr<void>(), resource));
+    }
+
+    if (upstream != nullptr)
+        document = Document::Create(counter != nullptr ? counter : upstream);
+    else if (counter != nullptr)
+        document = Document::Create(counter, resource);
+    else
+        document = Document::Create(resource);
+    document->Retain(input);
+
+    DocumentBuilder builder(*this);
+    const SourcePosition start = Position();
+
+    ParserResult result = [&] {
+        if (std::optional<ParserError> error = Parse(builder))
+            return ParserResult(error->error, error->line, error->column);
 
-            if (auto* obj = std::get_if<std::shared_ptr<Object>>(&result))
-                return ParserResult(*obj);
+        if (Object** obj = std::get_if<Object*>(&builder.root))
+            return ParserResult(document->Share(*obj));
+
+        else if (Array** arr = std::get_if<Array*>(&builder.root))
+            return ParserResult(document->Share(*arr));
+
+        return ParserResult(ErrorType::InvalidDocumentStartError, start.line, start.column);
+    }();
+
+    if constexpr (Statistics::Enabled) {
+        statistics.Get().allocations += counter->allocations;
+        statistics.Get().allocatedBytes += counter->bytes;
+        result.SetStatistics(statistics.Get());
+    }
+
+    return result;
+}
+
+std::optional<ParserError> YamlParser::Parse(YamlEventHandler& handler) {
+    if constexpr (Statistics::Enabled) {
+        // The parse is timed as a whole and the handler on its own, the difference is the lexing
+        StatisticsHandler counter(handler, statistics.Get());
+        handler.failure.reset();
+
+        const size_t offset = Offset();
+        uint64_t total = 0;
+        std::optional<ParserError> error;
+        {
+            PhaseTimer timer(total);
+            error = Run(counter);
+        }
+
+        statistics.Get().documents++;
+        statistics.Get().bytesRead += Offset() - offset;
+        statistics.Get().buildNanoseconds += counter.handlerNanoseconds;
+        statistics.Get().lexNanoseconds += total - std::min(total, counter.handlerNanoseconds);
+        return error;
+    }
+    else {
+        return Run(handler);
+    }
+}
 
-            else if (auto* arr = std::get_if<std::shared_ptr<Array>>(&result))
-                return ParserResult(*arr);
+std::optional<ParserError> YamlParser::Run(YamlEventHandler& handler) {
+    this->handler = &handler;
+    handler.failure.reset();
+    handler.failurePosition.reset();
+    failure.reset();
 
-            return ParserResult(ErrorType::InvalidDocumentStartError, 1, 1);
+    try {
+        try {
+            if (ParseValue())
+                return std::nullopt;
         } catch (ErrorType error) {
-            return ParserResult(error, line, column);
+            // Handlers that throw instead of calling Fail
+            return ParserError(error, line, column);
         }
     }
     
     // Catch any errors that are not of type ErrorType
     catch (...) {
-        return ParserResult(ErrorType::ParserInternalError, line, column);
+        return ParserError(ErrorType::ParserInternalError, line, column);
+    }
+
+    // Nothing moves the cursor while the failure is returned, so this is still where it happened
+    if (failure.has_value())
+        return ParserError(failure.value(), line, column);
+    if (handler.failure.has_value()) {
+        const SourcePosition position = handler.failurePosition.value_or(SourcePosition{ static_cast<long>(line), static_cast<long>(column) });
+        return ParserError(handler.failure.value(), position.line, position.column);
     }
+
+    // The handler stopped the parse
+    return std::nullopt;
 }
 
-ParserResult ParseYaml(const std::string& filePath) {
-    std::ifstream stream(filePath);
+std::optional<ParserError> YamlParser::ParseValueAt(size_t offset, SourcePosition position, YamlEventHandler& handler) {
+    cursor = begin + std::min(offset, static_cast<size_t>(end - begin));
+    line = static_cast<uint32_t>(position.line);
+    column = static_cast<uint32_t>(position.column);
+    while (!indentStack.empty())
+        indentStack.pop();
+    Load();
 
-    if (!stream.is_open())
+    return Parse(handler);
+}
+
+ParserResult ParseYaml(const std::string& filePath, ScalarStorage storage) {
+    uint64_t io = 0;
+    std::optional<InputSource> source;
+    {
+        PhaseTimer timer(io);
+        source = InputSource::FromFile(filePath);
+    }
+
+    if (!source.has_value())
         return ParserResult(ErrorType::FileOpenError, 0, 0);
 
-    YamlParser parser(stream);
+    std::shared_ptr<const InputSource> input = std::make_shared<const InputSource>(std::move(source.value()));
+
+    YamlParser parser(input->View(), storage);
+    parser.GetStatistics().ioNanoseconds += io;
+
+    // Only a document that views the file keeps it mapped
+    if (storage == ViewInput)
+        parser.RetainInput(input);
+
+    return parser.Parse();
+}
+
+ParserResult ParseYamlText(std::string_view input, ScalarStorage storage) {
+    YamlParser parser(input, storage);
+    return parser.Parse();
+}
+
+ParserResult ParseYamlText(std::string_view input, std::pmr::memory_resource* resource, ScalarStorage storage) {
+    YamlParser parser(input, storage, resource);
     return parser.Parse();
 }
+
+std::optional<ParserError> ParseYaml(const std::string& filePath, YamlEventHandler& handler) {
+    std::optional<InputSource> source = InputSource::FromFile(filePath);
+
+    if (!source.has_value())
+        return ParserError(ErrorType::FileOpenError, 0, 0);
+
+    // Events only view the file while the handler runs, and the file is unmapped when the parse returns
+    YamlParser parser(source->View(), ViewInput);
+    return parser.Parse(handler);
+}
+
+std::optional<ParserError> ParseYamlText(std::string_view input, YamlEventHandler& handler) {
+    YamlParser parser(input, ViewInput);
+    return parser.Parse(handler);
+}
\ No newline at end of file
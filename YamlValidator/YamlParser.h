@@ -1,22 +1,54 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
-#include <fstream>
 #include <map>
-#include <regex>
+#include <optional>
 #include <iostream>
 #include <stack>
+#include <memory_resource>
 
 #include "Types.h"
+#include "Statistics.h"
+#include "StructuralIndex.h"
 
 using namespace parser_types;
 
 #define INDENT_SIZE 2
 
-const std::string valueEndChars("]},\n:");
-const std::string invalidKeyChars(R"({}[]&*#?|<>=!%@\)");
-const std::string invalidValueChars(R"(:{}[]&*#?|<>=!%@\"')");
+constexpr std::string_view valueEndChars("]},\n:");
+constexpr std::string_view invalidKeyChars(R"({}[]&*#?|<>=!%@\)");
+constexpr std::string_view invalidValueChars(R"(:{}[]&*#?|<>=!%@\"')");
+
+/**
+ * @struct CharacterTable
+ * @brief Struct representing a set of characters as one flag per byte value, so that
+ *        testing a character is a single load instead of a search through the set.
+ */
+struct CharacterTable {
+    bool contains[256] = {}; /// True for the byte values in the set.
+
+    /**
+     * @brief Constructor for CharacterTable.
+     * @param chars The characters in the set.
+     */
+    constexpr CharacterTable(std::string_view chars) {
+        for (char c : chars)
+            contains[static_cast<unsigned char>(c)] = true;
+    }
+
+    /**
+     * @brief Checks whether a character is in the set.
+     * @param c The character.
+     * @return True if c is one of the characters the table was built from.
+     */
+    constexpr bool operator()(char c) const { return contains[static_cast<unsigned char>(c)]; }
+};
+
+constexpr CharacterTable isValueEnd(valueEndChars);
+constexpr CharacterTable isInvalidKey(invalidKeyChars);
+constexpr CharacterTable isInvalidValue(invalidValueChars);
 
 /**
  * @enum ErrorType
@@ -67,6 +99,15 @@ enum ErrorType {
     ParserInternalError,
 };
 
+/**
+ * @enum ScalarStorage
+ * @brief Enum representing where the characters of parsed keys and scalars are stored.
+ */
+enum ScalarStorage {
+    CopyScalars,    /// Every key and scalar is copied into the document. The input may be released after parsing.
+    ViewInput,      /// Keys and scalars view the input in place, only escaped ones are copied. The input must outlive the document.
+};
+
 /**
  * @struct ParserError
  * @brief Struct representing a parser error.
@@ -93,6 +134,7 @@ struct ParserError {
 class ParserResult {
 private:
     std::variant<Yaml, ParserError> result; /// The result of the parse operation.
+    YAML_VALIDATOR_NO_UNIQUE_ADDRESS StatisticsSlot<> statistics; /// What the parse took, when Statistics are collected.
 
 public:
     /**
@@ -156,6 +198,117 @@ public:
             return std::get<ParserError>(result);
         return std::nullopt;
     }
+
+    /**
+     * @brief Get what the parse took.
+     * @return The Statistics of the parse, all 0 unless YAML_VALIDATOR_STATISTICS is defined.
+     */
+    const Statistics& GetStatistics() const { return statistics.Get(); }
+
+    /**
+     * @brief Replaces the Statistics of the parse. Does nothing unless YAML_VALIDATOR_STATISTICS is defined.
+     * @param value The new Statistics.
+     */
+    void SetStatistics(const Statistics& value) { statistics.Set(value); }
+};
+
+/**
+ * @struct SourcePosition
+ * @brief Struct representing where something is in the input.
+ */
+struct SourcePosition {
+    long line;          /// The line number, starting at 1.
+    long column;        /// The column number, starting at 1.
+};
+
+/**
+ * @class YamlEventHandler
+ * @brief Interface for consumers that react to the structure of a Yaml document
+ *        while it is parsed, instead of walking a Document afterwards.
+ * @note Events arrive in document order. Every BeginObject is matched by an EndObject and
+ *       every BeginArray by an EndArray, unless the parse fails or is stopped.
+ *       Keys and String, Number and Timestamp values are only valid for the duration
+ *       of the call. A handler fails the parse at the current position by returning Fail(error),
+ *       or at the position of an event by returning Fail(error, position).
+ *       Throwing an ErrorType does the same, but unwinding is far slower than returning.
+ */
+class YamlEventHandler {
+private:
+    friend class YamlParser;
+
+    std::optional<ErrorType> failure;   /// The error passed to Fail, cleared when a parse starts.
+    std::optional<SourcePosition> failurePosition; /// Where the error passed to Fail happened, the current position if nullopt.
+
+protected:
+    /**
+     * @brief Fails the parse at the current position.
+     * @param error The error to report.
+     * @return False, to be returned from the event that failed.
+     */
+    bool Fail(ErrorType error) {
+        failure = error;
+        failurePosition.reset();
+        return false;
+    }
+
+    /**
+     * @brief Fails the parse at the given position, eg. the start of the key an event was called for.
+     * @param error The error to report.
+     * @param position Where the error happened.
+     * @return False, to be returned from the event that failed.
+     */
+    bool Fail(ErrorType error, SourcePosition position) {
+        failure = error;
+        failurePosition = position;
+        return false;
+    }
+
+public:
+    virtual ~YamlEventHandler() = default;
+
+    /**
+     * @brief Called when an object starts. Its keys and values follow until the matching EndObject.
+     * @param position Where the object starts: its { or, for block objects, its first key.
+     * @return False to stop parsing, true to continue.
+     */
+    virtual bool BeginObject(SourcePosition position) = 0;
+
+    /**
+     * @brief Called for each key of the innermost open object, before its value.
+     * @param key The key, with quotes removed and escapes resolved.
+     * @param position Where the key starts, including any opening quote.
+     * @return False to stop parsing, true to continue.
+     */
+    virtual bool Key(std::string_view key, SourcePosition position) = 0;
+
+    /**
+     * @brief Called when the innermost open object ends.
+     * @param position Where the object ends: its } or, for block objects, the first character after it.
+     * @return False to stop parsing, true to continue.
+     */
+    virtual bool EndObject(SourcePosition position) = 0;
+
+    /**
+     * @brief Called when an array starts. Its items follow until the matching EndArray.
+     * @param position Where the array starts: its [ or its first -.
+     * @return False to stop parsing, true to continue.
+     */
+    virtual bool BeginArray(SourcePosition position) = 0;
+
+    /**
+     * @brief Called when the innermost open array ends.
+     * @param position Where the array ends: its ] or, for block arrays, the first character after it.
+     * @return False to stop parsing, true to continue.
+     */
+    virtual bool EndArray(SourcePosition position) = 0;
+
+    /**
+     * @brief Called for each scalar value.
+     * @param value The scalar with its type resolved, never an Object* or Array*.
+     * @param position Where the scalar starts, including any opening quote.
+     * @return False to stop parsing, true to continue.
+     */
+    virtual bool Scalar(const YamlValue& value, SourcePosition position) = 0;
 };
 
 /**
@@ -164,128 +317,397 @@ public:
  */
 class YamlParser {
 private:
-    std::ifstream& stream;                  /// A reference to the input file stream.
+    const char* begin;                      /// Pointer to the first character of the input buffer.
+    const char* cursor;                     /// Pointer to the current character in the input buffer.
+    const char* end;                        /// Pointer one past the last character of the input buffer.
 
-    char currChar;                          /// The current character being processed.
-    char peekChar;                          /// The next character being processed.
+    char currChar = '\0';                   /// The current character being processed, '\0' at end of input.
+    char peekChar = '\0';                   /// The next character being processed, '\0' at end of input.
 
     uint32_t line = 1;                      /// The current line number.
     uint32_t column = 1;                    /// The current column number.
 
     bool isEOF = false;                     /// Flag indicating if the end of file has been reached.
-    bool isPeekEOF = false;                 /// Flag indicating if the end of file has been reached.
+    bool isPeekEOF = false;                 /// Flag indicating if the next character is past the end of file.
+
+    std::pmr::memory_resource* resource;    /// Where the working memory of the parser, and the document unless SetUpstreamResource was called, come from.
+    std::stack<uint32_t, std::pmr::vector<uint32_t>> indentStack; /// Stack for keeping track of indentation levels.
+
+    StructuralIndex index;                  /// Finds the next character that keys and scalars have to look at.
+
+    YamlEventHandler* handler = nullptr;    /// Receives the structure of the input while it is parsed.
+
+    std::shared_ptr<Document> document;     /// The Document that owns every parsed container, key and scalar. Only created by Parse().
+    std::shared_ptr<const void> input;      /// Owner of the input, handed to the document.
+    std::shared_ptr<std::pmr::memory_resource> upstream; /// Where the document gets its memory from, the default resource if nullptr.
+    ScalarStorage storage;                  /// Whether keys and scalars may view the input in place.
 
-    std::stack<uint32_t> indentStack;       /// Stack for keeping track of indentation levels.
+    std::optional<ErrorType> failure;       /// The error the parse failed with, if any.
+
+    YAML_VALIDATOR_NO_UNIQUE_ADDRESS StatisticsSlot<> statistics; /// What the parses so far took, when Statistics are collected.
+
+    class DocumentBuilder;
+    class StatisticsHandler;
 
     /**
-     * @brief Advances the parser to the next character in the input file stream.
+     * @brief Counts the classifiers that were called to find the type of an unquoted scalar.
+     * @param calls The number of classifiers called.
      */
-    void Advance();       
+    void CountClassifierCalls(uint64_t calls) {
+        if constexpr (Statistics::Enabled)
+            statistics.Get().classifierCalls += calls;
+    }
 
     /**
-     * @brief Advances the parser to the next character that is not whitespace.
+     * @brief Parses the input and reports its structure to a handler, like Parse(YamlEventHandler&), without collecting Statistics.
      */
-    void SkipWhitespace();
+    std::optional<ParserError> Run(YamlEventHandler& handler);
 
     /**
-     * @brief Checks if the current character matches the expected one.
-     * @param c The expected character.
-     * @param error The error to be thrown if the characters does not match.
-     * @throws ParserError if the characters does not match.
+     * @brief Records an error at the current position.
+     * @param error The error to report.
+     * @return False, to be returned all the way up to Parse.
+     * @note Errors are passed up as return values instead of exceptions, because
+     *       invalid input is common and unwinding would dominate the time spent on it.
      */
-    void Expect(char c, ErrorType error);
+    bool Fail(ErrorType error) {
+        failure = error;
+        return false;
+    }
+
+    const char* scalarStart = nullptr;      /// First input character of the scalar or key being read.
+    const char* scalarEnd = nullptr;        /// One past the last input character of the scalar or key being read.
+    bool scalarOwned = false;               /// True once the scalar or key differs from the input bytes and is built in scratch.
+    std::pmr::string scratch;               /// Reused buffer for scalars and keys that needed unescaping.
 
     /**
-     * @brief Consumes and parses the input stream into a YamlValue.
-     * @return The parsed value as a YamlValue variant.
-     * @throws ParserError if the value is invalid.
+     * @brief Reloads currChar, peekChar and the EOF flags from the cursor.
      */
-    YamlValue ParseValue();
+    void Load() {
+        isEOF = cursor >= end;
+        isPeekEOF = cursor + 1 >= end;
+        currChar = isEOF ? '\0' : cursor[0];
+        peekChar = isPeekEOF ? '\0' : cursor[1];
+    }
 
     /**
-     * @brief Consumes and parses an object key from the input stream.
-     * @return The parsed key as a string.
-     * @throws ParserError if the key is invalid.
+     * @brief Advances the parser to the next character in the input buffer.
      */
-    std::string ParseObjectKey();
+    void Advance();
 
     /**
-     * @brief Checks if the input string is a valid Yaml boolean.
-     * @return An optional containing the boolean value if the string 
-     *         represents a valid Yaml boolean if valid, std::nullopt otherwise.
+     * @brief Starts reading a new scalar or key at the current character.
      */
-    static std::optional<bool> IsBoolean(const std::string& value);
+    void BeginScalar() {
+        scalarStart = scalarEnd = cursor;
+        scalarOwned = false;
+        scratch.clear();
+    }
 
     /**
-     * @brief Checks if the input string is a valid Yaml number.
-     * @return True if the input string is a valid Yaml number, false otherwise.
+     * @brief Adds the current character, unchanged, to the scalar or key being read.
+     * @note Only moves scalarEnd while the scalar still matches the input bytes.
      */
-    static bool IsNumber(const std::string& value);
+    void AppendCurrent() {
+        if (scalarOwned)
+            scratch.push_back(currChar);
+        else
+            scalarEnd = cursor + 1;
+    }
 
     /**
-     * @brief Checks if the input string is a valid Yaml null value.
-     * @return True if the input string is a valid Yaml null value, false otherwise.
+     * @brief Adds the characters from the current one up to the next one in set, unchanged,
+     *        to the scalar or key being read, and advances past them.
+     * @param set The characters that the scalar or key cannot take without looking at them.
+     * @note None of the characters is a newline, so only the column moves.
      */
-    static bool IsNull(const std::string& value);
+    void AppendPlain(StructuralIndex::CharacterSet set) {
+        const char* next = index.Next(cursor, set);
+        if (next == cursor)
+            return;
+
+        if (scalarOwned)
+            scratch.append(cursor, next);
+        else
+            scalarEnd = next;
+
+        column += static_cast<uint32_t>(next - cursor);
+        cursor = next;
+        Load();
+    }
 
     /**
-     * @brief Checks if the input string is valid ISO8601 timestamp.
-     * @return True if the input string is a valid ISO8601 timestamp, false otherwise.
+     * @brief Adds a character that is not in the input at this position, eg. an unescaped quote.
+     * @param c The character to add.
+     */
+    void AppendUnescaped(char c) {
+        if (!scalarOwned) {
+            scratch.assign(scalarStart, scalarEnd);
+            scalarOwned = true;
+        }
+        scratch.push_back(c);
+    }
+
+    /**
+     * @brief Get the scalar or key read so far.
+     * @return A view into the input or into scratch, valid until the next BeginScalar.
+     */
+    std::string_view CurrentScalar() const {
+        if (scalarOwned)
+            return scratch;
+        return std::string_view(scalarStart, scalarEnd - scalarStart);
+    }
+
+    /**
+     * @brief Makes the scalar or key read so far outlive the parse.
+     * @return A view into the input when possible under ViewInput, otherwise a copy owned by the document.
+     */
+    std::string_view KeepScalar() {
+        if (!scalarOwned && storage == ViewInput)
+            return CurrentScalar();
+        return document->CopyString(CurrentScalar());
+    }
+
+    /**
+     * @brief Advances the parser to the next character that is not whitespace.
      */
-    static bool IsTimestamp(const std::string& value);
+    void SkipWhitespace();
+
+    /**
+     * @brief Checks if the current character matches the expected one.
+     * @param c The expected character.
+     * @param error The error to be reported if the characters does not match.
+     * @return False if the characters does not match.
+     */
+    [[nodiscard]] bool Expect(char c, ErrorType error);
+
+    /**
+     * @brief Consumes and parses a value from the input stream and reports it to the handler.
+     * @return False if the value is invalid or the handler stopped the parse.
+     */
+    [[nodiscard]] bool ParseValue();
+
+    /**
+     * @brief Consumes and parses an object key from the input stream.
+     * @note The key is left in the scalar being read, see CurrentScalar.
+     * @return False if the key is invalid.
+     */
+    [[nodiscard]] bool ParseObjectKey();
 
     /**
      * @brief Consumes and parses the input stream as a Yaml Object.
-     * @param firstKey The first key of the object. This is necessary due
-     *                 to how LL(1) parsers work.
-     * @return Object containing a mapping of key-value pairs.
-     * @throw ParserError if the input stream represents an invalid Yaml object.
+     * @param firstKey Where the first key of the object starts. The key itself must already
+     *                 be the scalar being read. This is necessary due to how LL(1) parsers work.
+     * @return False if the input stream represents an invalid Yaml object or the handler stopped the parse.
      */
-    Object ParseYamlObject(const std::string& firstKey);
+    [[nodiscard]] bool ParseYamlObject(SourcePosition firstKey);
 
     /**
      * @brief Consumes and parses the input stream as a Yaml Array.
-     * @return Array containing a list of YamlValue items.
-     * @throw ParserError if the input stream represents an invalid Yaml array.
+     * @return False if the input stream represents an invalid Yaml array or the handler stopped the parse.
      */
-    Array ParseYamlArray();
+    [[nodiscard]] bool ParseYamlArray();
 
     /*
      * @brief Consumes and parses the input stream as a Json-like object.
-     * @note `currChar` MUST be `{` when calling this method. Otherwise, an error will be thrown.
-     * @throws ParserError if currChar != '{'.
+     * @note `currChar` MUST be `{` when calling this method. Otherwise, an error will be reported.
+     * @return False if the object is invalid or the handler stopped the parse.
      */
-    Object ParseJsonObject();
+    [[nodiscard]] bool ParseJsonObject();
 
     /*
      * @brief Consumes and parses the input stream as a Json-like array.
-     * @note `currChar` MUST be `[` when calling this method. Otherwise an error will be thrown.
-     * @throws ParserError if currChar != '['.
+     * @note `currChar` MUST be `[` when calling this method. Otherwise an error will be reported.
+     * @return False if the array is invalid or the handler stopped the parse.
      */
-    Array ParseJsonArray();
+    [[nodiscard]] bool ParseJsonArray();
     
 public:
     /**
      * @brief Constructor for YamlParser.
-     * @param stream Reference to the input file stream.
+     * @param input The bytes to parse. Must stay valid for the lifetime of the parser,
+     *              and for the lifetime of the parsed document when storage is ViewInput.
+     * @param storage Whether keys and scalars may view the input in place.
+     * @param resource Where the parser and the parsed document allocate their memory, eg. a buffer
+     *                 per request. Must outlive the parser and the document. The default resource if nullptr.
+     */
+    YamlParser(std::string_view input, ScalarStorage storage = CopyScalars, std::pmr::memory_resource* resource = nullptr)
+        : begin(input.data()), cursor(input.data()), end(input.data() + input.size()),
+          resource(resource != nullptr ? resource : std::pmr::get_default_resource()),
+          indentStack(std::pmr::vector<uint32_t>(this->resource)), index(input), storage(storage), scratch(this->resource) {
+        Load();
+    }
+
+    /**
+     * @brief Makes the parsed document keep the owner of the input alive.
+     * @param owner Owner of the bytes passed to the constructor, eg. an InputSource.
+     */
+    void RetainInput(std::shared_ptr<const void> owner) { input = std::move(owner); }
+
+    /**
+     * @brief Makes the parsed document allocate its arena blocks from the given resource
+     *        instead of the one passed to the constructor.
+     * @param resource The resource, eg. a pool that recycles memory between documents.
+     *                 Kept alive by the document.
+     */
+    void SetUpstreamResource(std::shared_ptr<std::pmr::memory_resource> resource) { upstream = std::move(resource); }
+
+    /**
+     * @brief Get where the parser allocates its working memory.
+     * @return The resource passed to the constructor, or the default resource.
+     */
+    std::pmr::memory_resource* GetMemoryResource() const { return resource; }
+
+    /**
+     * @brief Makes positions count from the given line and column instead of 1:1.
+     * @param position Line and column of the first character of the input, eg. when it is one document of a larger stream.
      */
-    YamlParser(std::ifstream& stream) : stream(stream) {
-        stream.get(currChar);
-        stream.get(peekChar);
+    void SetStartPosition(SourcePosition position) {
+        line = static_cast<uint32_t>(position.line);
+        column = static_cast<uint32_t>(position.column);
     }
 
+    /**
+     * @brief Checks if the input string is a valid Yaml boolean.
+     * @return An optional containing the boolean value if the string 
+     *         represents a valid Yaml boolean if valid, std::nullopt otherwise.
+     */
+    static std::optional<bool> IsBoolean(std::string_view value);
+
+    /**
+     * @brief Checks if the input string is a valid Yaml number.
+     * @note Accepts decimal and exponent notation, 0x hexadecimal, 0o octal, .inf and .nan.
+     *       Single pass and allocation-free.
+     * @return True if the input string is a valid Yaml number, false otherwise.
+     */
+    static bool IsNumber(std::string_view value);
+
+    /**
+     * @brief Checks if the input string is a valid Yaml null value.
+     * @return True if the input string is a valid Yaml null value, false otherwise.
+     */
+    static bool IsNull(std::string_view value);
+
+    /**
+     * @brief Checks if the input string is valid ISO8601 timestamp.
+     * @note Accepts the same strings as the regex from
+     *       https://www.myintervals.com/blog/2009/05/20/iso-8601-date-validation-that-doesnt-suck/
+     *       without constructing a std::regex. Allocation-free.
+     * @return True if the input string is a valid ISO8601 timestamp, false otherwise.
+     */
+    static bool IsTimestamp(std::string_view value);
+
     /**
      * @brief Parses the input stream into a Yaml object.
      * @return A ParserResult object containing either the parsed
      *         Yaml object or a ParseError object.
      */
     ParserResult Parse();
+
+    /**
+     * @brief Parses the input stream and reports its structure to a handler
+     *        instead of building a Document.
+     * @param handler The handler that receives the events.
+     * @return std::nullopt if the input was parsed, or the handler stopped the parse early.
+     *         The ParserError otherwise.
+     */
+    std::optional<ParserError> Parse(YamlEventHandler& handler);
+
+    /**
+     * @brief Parses a single value that starts somewhere inside the input, eg. to parse part of
+     *        a document again after it was edited.
+     * @param offset Byte offset of the first character of the value.
+     * @param position Line and column of that character.
+     * @param handler The handler that receives the events.
+     * @note The events are the same that Parse would send for the value when reaching it, since
+     *       nothing the parser does inside a value depends on the input before it.
+     *       Offset() and Position() tell where the parse continued after the value.
+     * @return std::nullopt if the value was parsed, or the handler stopped the parse early.
+     *         The ParserError otherwise.
+     */
+    std::optional<ParserError> ParseValueAt(size_t offset, SourcePosition position, YamlEventHandler& handler);
+
+    /**
+     * @brief Get the position of the current character.
+     * @return The current line and column.
+     */
+    SourcePosition Position() const {
+        return { static_cast<long>(line), static_cast<long>(column) };
+    }
+
+    /**
+     * @brief Get what the parses of this parser took so far. Parse() copies them into its result.
+     * @return The Statistics, all 0 unless YAML_VALIDATOR_STATISTICS is defined.
+     */
+    const Statistics& GetStatistics() const { return statistics.Get(); }
+
+    /**
+     * @brief Get the Statistics of this parser to add to them, eg. the time it took to read its input.
+     * @return The Statistics, only worth updating when Statistics::Enabled.
+     */
+    Statistics& GetStatistics() { return statistics.Get(); }
+
+    /**
+     * @brief Get the byte offset of the current character.
+     * @return The number of input bytes before it.
+     */
+    size_t Offset() const {
+        return static_cast<size_t>(cursor - begin);
+    }
 };
 
 /**
  * @brief Parses a Yaml file.
  * @param filePath The file path to the input file.
+ * @param storage Whether keys and scalars may view the file in place. With CopyScalars the
+ *                file is closed before this returns. With ViewInput the parsed document keeps
+ *                the file mapped instead, and its keys and scalars read the mapping directly.
+ * @warning Only pass ViewInput for files that nothing truncates or rewrites in place while the
+ *          document is alive, eg. by an editor save or a deploy. Otherwise reading a key or
+ *          scalar can return the new contents or raise SIGBUS.
  * @return A ParserResult object containing either the parsed
  *         Yaml object or a ParseError object.
  */
-ParserResult ParseYaml(const std::string& filePath);
\ No newline at end of file
+ParserResult ParseYaml(const std::string& filePath, ScalarStorage storage = CopyScalars);
+
+/**
+ * @brief Parses Yaml data that is already in memory.
+ * @param input The Yaml data itself, not a file path. With CopyScalars the bytes only
+ *              need to stay valid for the duration of the call. With ViewInput they
+ *              must stay valid for as long as the result or any value taken from it.
+ * @param storage Whether keys and scalars may view the input in place.
+ * @return A ParserResult object containing either the parsed
+ *         Yaml object or a ParseError object.
+ */
+ParserResult ParseYamlText(std::string_view input, ScalarStorage storage = CopyScalars);
+
+/**
+ * @brief Parses Yaml data that is already in memory, allocating from the given resource.
+ * @param input The Yaml data itself, not a file path. See ParseYamlText(std::string_view, ScalarStorage).
+ * @param resource Where the parser and the parsed document allocate their memory, eg. a
+ *                 std::pmr::monotonic_buffer_resource per request or a pool per thread.
+ *                 Must stay alive for as long as the result or any value taken from it.
+ * @param storage Whether keys and scalars may view the input in place.
+ * @return A ParserResult object containing either the parsed
+ *         Yaml object or a ParseError object.
+ */
+ParserResult ParseYamlText(std::string_view input, std::pmr::memory_resource* resource, ScalarStorage storage = CopyScalars);
+
+/**
+ * @brief Parses a Yaml file and reports its structure to a handler instead of building a Document.
+ * @param filePath The file path to the input file.
+ * @param handler The handler that receives the events.
+ * @return std::nullopt if the file was parsed, or the handler stopped the parse early.
+ *         The ParserError otherwise.
+ */
+std::optional<ParserError> ParseYaml(const std::string& filePath, YamlEventHandler& handler);
+
+/**
+ * @brief Parses Yaml data that is already in memory and reports its structure to a handler
+ *        instead of building a Document.
+ * @param input The Yaml data itself, not a file path. Only needs to stay valid for the duration of the call.
+ * @param handler The handler that receives the events.
+ * @return std::nullopt if the input was parsed, or the handler stopped the parse early.
+ *         The ParserError otherwise.
+ */
+std::optional<ParserError> ParseYamlText(std::string_view input, YamlEventHandler& handler);